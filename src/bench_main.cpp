@@ -0,0 +1,102 @@
+// Headless Lazy SMP benchmark - no SFML dependency.
+//
+// Usage:
+//   bench [--depth N] [--threads N] [--hash MB] [--eval-file <file.nnue>]
+//
+// Searches a fixed position set to a fixed depth with 1, 2, 4, ... up to N threads
+// (N included) and prints time-to-depth, NPS and the speedup over one thread.
+// The table is cleared before every position so all runs start cold.
+#include "model/Bench.hpp"
+#include "model/Notation.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        int depth = 6;
+        int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        size_t hash_mb = 64;
+        std::string eval_file;
+    };
+
+    bool parse_options(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            if (arg == "--depth")
+                options.depth = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--threads")
+                options.max_threads = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--hash")
+                options.hash_mb = std::stoul(argv[++i]);
+            else if (arg == "--eval-file")
+                options.eval_file = argv[++i];
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        std::cerr << "Usage: bench [--depth N] [--threads N] [--hash MB] [--eval-file <file.nnue>]\n";
+        return 2;
+    }
+
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < options.max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(options.max_threads);
+
+    TranspositionTable table(options.hash_mb);
+    SearchPool pool(table);
+    NnueNetwork network;
+    if (!options.eval_file.empty())
+    {
+        if (!network.load(options.eval_file))
+        {
+            std::cerr << "Cannot load network " << options.eval_file << "\n";
+            return 1;
+        }
+        pool.set_network(&network);
+        std::cout << "NNUE: " << options.eval_file << " (" << NnueNetwork::backend_name(network.get_backend()) << ")\n";
+    }
+    double single_thread_seconds = 0.0;
+
+    std::vector<std::pair<int, BenchResult>> results;
+    for (int threads : thread_counts)
+    {
+        std::cout << "Threads: " << threads << " (depth " << options.depth << ")\n";
+        pool.set_threads(threads);
+        BenchResult result = run_bench(pool, table, options.depth, [](const std::string &fen, Move best, double seconds)
+                                       { std::cout << "  " << std::setw(8) << move_to_uci(best) << std::setw(10) << std::fixed
+                                                   << std::setprecision(3) << seconds << "s  " << fen << "\n"; });
+        if (threads == 1)
+            single_thread_seconds = result.seconds;
+        results.emplace_back(threads, result);
+    }
+
+    std::cout << "\nThreads      Time         Nodes          NPS  Speedup\n";
+    for (const auto &[threads, result] : results)
+    {
+        long long nps = result.seconds > 0 ? static_cast<long long>(result.nodes / result.seconds) : 0;
+        double speedup = result.seconds > 0 ? single_thread_seconds / result.seconds : 0.0;
+        std::cout << std::setw(7) << threads << std::setw(9) << std::fixed << std::setprecision(3)
+                  << result.seconds << "s" << std::setw(14) << result.nodes << std::setw(13) << nps
+                  << std::setw(8) << std::setprecision(2) << speedup << "x\n";
+    }
+    return 0;
+}
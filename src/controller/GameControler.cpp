@@ -64,7 +64,7 @@ void GameControler::handleEvents()
 
                     for (const auto &move : validMoves)
                     {
-                        if (move.source == promotionSource && move.target == promotionTarget && move.promotion == selected_piece)
+                        if (move.source() == promotionSource && move.target() == promotionTarget && move.promotion() == selected_piece)
                         {
                             board.make_move(move);
                             check_game_over();
@@ -102,10 +102,10 @@ void GameControler::handleEvents()
                             currentMousePos = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
 
                             validMoves.clear();
-                            const std::vector<Move> &legal_moves = board.get_legal_moves();
+                            const MoveList &legal_moves = board.get_legal_moves();
                             for (const auto &move : legal_moves)
                             {
-                                if (move.source == square)
+                                if (move.source() == square)
                                 {
                                     validMoves.push_back(move);
                                 }
@@ -128,9 +128,9 @@ void GameControler::handleEvents()
                     {
                         for (const auto &move : validMoves)
                         {
-                            if (move.source == draggedSquare && move.target == destSquare)
+                            if (move.source() == draggedSquare && move.target() == destSquare)
                             {
-                                if (move.promotion)
+                                if (move.promotion())
                                 {
                                     isPromoting = true;
                                     promotionSource = draggedSquare;
@@ -172,9 +172,9 @@ void GameControler::render()
     {
         for (const auto &move : validMoves)
         {
-            if (move.source == draggedSquare)
+            if (move.source() == draggedSquare)
             {
-                highlight_squares.push_back(move.target);
+                highlight_squares.push_back(move.target());
             }
         }
     }
@@ -1,25 +1,142 @@
 #include "Attacks.hpp"
 #include "Magics.hpp"
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 
-Bitboard knight_attacks[64];
-Bitboard pawn_attacks[2][64];
-Bitboard king_attacks[64];
-Bitboard between[64][64];
+namespace
+{
+    constexpr int distance(int a, int b)
+    {
+        return a > b ? a - b : b - a;
+    }
+
+    // Squares reached by the given (file, rank) offsets, without wrapping around the board
+    constexpr std::array<Bitboard, 64> make_leaper_attacks(const int (&offsets)[8][2])
+    {
+        std::array<Bitboard, 64> table{};
+        for (int square = 0; square < 64; square++)
+        {
+            int rank = square / 8;
+            int file = square % 8;
+            for (int i = 0; i < 8; i++)
+            {
+                int target_file = file + offsets[i][0];
+                int target_rank = rank + offsets[i][1];
+                if (target_rank >= 0 && target_rank < 8 && target_file >= 0 && target_file < 8)
+                    table[square] |= 1ULL << (target_rank * 8 + target_file);
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<std::array<Bitboard, 64>, 2> make_pawn_attacks()
+    {
+        std::array<std::array<Bitboard, 64>, 2> table{};
+        for (int square = 0; square < 64; square++)
+        {
+            int rank = square / 8;
+            int file = square % 8;
+
+            // Capture up-left (file-1, rank+1) -> +7
+            if (rank < 7 && file > 0)
+                table[WHITE][square] |= 1ULL << (square + 7);
+            // Capture up-right (file+1, rank+1) -> +9
+            if (rank < 7 && file < 7)
+                table[WHITE][square] |= 1ULL << (square + 9);
+
+            // Black pawns
+            // Capture down-left (file-1, rank-1) -> -9
+            if (rank > 0 && file > 0)
+                table[BLACK][square] |= 1ULL << (square - 9);
+            // Capture down-right (file+1, rank-1) -> -7
+            if (rank > 0 && file < 7)
+                table[BLACK][square] |= 1ULL << (square - 7);
+        }
+        return table;
+    }
+
+    constexpr std::array<std::array<Bitboard, 64>, 64> make_between()
+    {
+        std::array<std::array<Bitboard, 64>, 64> table{};
+        for (int sq1 = 0; sq1 < 64; sq1++)
+        {
+            for (int sq2 = 0; sq2 < 64; sq2++)
+            {
+                if (sq1 == sq2)
+                    continue;
+                int file1 = sq1 % 8, file2 = sq2 % 8;
+                int rank1 = sq1 / 8, rank2 = sq2 / 8;
+                int dx = file2 - file1, dy = rank2 - rank1;
+                // same file, rank, \ and /
+                if (dx != 0 && dy != 0 && distance(file1, file2) != distance(rank1, rank2))
+                    continue;
+                int step_x = (dx == 0) ? 0 : (dx > 0 ? 1 : -1);
+                int step_y = (dy == 0) ? 0 : (dy > 0 ? 1 : -1);
+                int step = step_y * 8 + step_x;
+                for (int current = sq1 + step; current != sq2; current += step)
+                    table[sq1][sq2] |= 1ULL << current;
+            }
+        }
+        return table;
+    }
 
-static void init_knight_attacks();
-static void init_pawn_attacks();
-static void init_king_attacks();
-static void init_between();
+    constexpr std::array<std::array<Bitboard, 64>, 64> make_line()
+    {
+        std::array<std::array<Bitboard, 64>, 64> table{};
+        for (int sq1 = 0; sq1 < 64; sq1++)
+        {
+            for (int sq2 = 0; sq2 < 64; sq2++)
+            {
+                if (sq1 == sq2)
+                    continue;
+                int file1 = sq1 % 8, file2 = sq2 % 8;
+                int rank1 = sq1 / 8, rank2 = sq2 / 8;
+                int dx = file2 - file1, dy = rank2 - rank1;
+                if (dx != 0 && dy != 0 && distance(file1, file2) != distance(rank1, rank2))
+                    continue;
+                int step_x = (dx == 0) ? 0 : (dx > 0 ? 1 : -1);
+                int step_y = (dy == 0) ? 0 : (dy > 0 ? 1 : -1);
+                // Walk from sq1 to both edges of the board
+                for (int direction = -1; direction <= 1; direction += 2)
+                    for (int file = file1, rank = rank1; file >= 0 && file < 8 && rank >= 0 && rank < 8;
+                         file += direction * step_x, rank += direction * step_y)
+                        table[sq1][sq2] |= 1ULL << (rank * 8 + file);
+            }
+        }
+        return table;
+    }
 
-void init_attacks()
+    // All 8 possible knight / king moves (dx, dy)
+    constexpr int knight_jumps[8][2] = {
+        {1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}};
+    constexpr int king_steps[8][2] = {
+        {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+}
+
+#ifdef USE_PEXT
+namespace
 {
-    init_knight_attacks();
-    init_pawn_attacks();
-    init_king_attacks();
-    init_between();
+    // A PEXT build cannot run without BMI2 - stop with a message instead of an illegal instruction
+    const bool bmi2_checked = []
+    {
+        // Runs during static initialization - the CPU model has to be initialized by hand
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("bmi2"))
+        {
+            std::fputs("This build indexes slider attacks with BMI2 PEXT (-DENGINE_PEXT=ON), which this CPU does not support\n", stderr);
+            std::abort();
+        }
+        return true;
+    }();
 }
+#endif
+
+constexpr std::array<Bitboard, 64> knight_attacks = make_leaper_attacks(knight_jumps);
+constexpr std::array<std::array<Bitboard, 64>, 2> pawn_attacks = make_pawn_attacks();
+constexpr std::array<Bitboard, 64> king_attacks = make_leaper_attacks(king_steps);
+constexpr std::array<std::array<Bitboard, 64>, 64> between = make_between();
+constexpr std::array<std::array<Bitboard, 64>, 64> line = make_line();
 
 Bitboard get_rook_attacks_slow(int square, Bitboard occupied)
 {
@@ -83,113 +200,3 @@ Bitboard get_queen_attacks_slow(int square, Bitboard occupied)
 {
     return get_rook_attacks(square, occupied) | get_bishop_attacks(square, occupied);
 }
-
-static void init_pawn_attacks()
-{
-    for (int square = 0; square < 64; square++)
-    {
-        int rank = square / 8;
-        int file = square % 8;
-
-        // Capture up-left (file-1, rank+1) -> +7
-        if (rank < 7 && file > 0)
-            pawn_attacks[0][square] |= (1ULL << (square + 7));
-        // Capture up-right (file+1, rank+1) -> +9
-        if (rank < 7 && file < 7)
-            pawn_attacks[0][square] |= (1ULL << (square + 9));
-
-        // Black pawns (index 1)
-        // Capture down-left (file-1, rank-1) -> -9
-        if (rank > 0 && file > 0)
-            pawn_attacks[1][square] |= (1ULL << (square - 9));
-        // Capture down-right (file+1, rank-1) -> -7
-        if (rank > 0 && file < 7)
-            pawn_attacks[1][square] |= (1ULL << (square - 7));
-    }
-}
-
-static void init_knight_attacks()
-{
-    for (int square = 0; square < 64; square++)
-    {
-        Bitboard attacks = 0ULL;
-        int rank = square / 8;
-        int file = square % 8;
-
-        // All 8 possible knight moves (dx, dy)
-        int jumps[8][2] = {
-            {1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}};
-
-        for (int i = 0; i < 8; i++)
-        {
-            int target_file = file + jumps[i][0];
-            int target_rank = rank + jumps[i][1];
-
-            if (target_rank >= 0 && target_rank < 8 && target_file >= 0 && target_file < 8)
-            {
-                int target_square = target_rank * 8 + target_file;
-                attacks |= (1ULL << target_square);
-            }
-        }
-        knight_attacks[square] = attacks;
-    }
-}
-
-static void init_king_attacks()
-{
-    for (int square = 0; square < 64; square++)
-    {
-        Bitboard attacks = 0ULL;
-        int rank = square / 8;
-        int file = square % 8;
-
-        // All 8 possible king moves (dx, dy)
-        int moves[8][2] = {
-            {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
-
-        for (int i = 0; i < 8; i++)
-        {
-            int target_file = file + moves[i][0];
-            int target_rank = rank + moves[i][1];
-
-            if (target_rank >= 0 && target_rank < 8 && target_file >= 0 && target_file < 8)
-            {
-                int target_square = target_rank * 8 + target_file;
-                attacks |= (1ULL << target_square);
-            }
-        }
-        king_attacks[square] = attacks;
-    }
-}
-
-static void init_between()
-{
-    for (int sq1 = 0; sq1 < 64; sq1++)
-    {
-        for (int sq2 = 0; sq2 < 64; sq2++)
-        {
-            between[sq1][sq2] = 0ULL;
-            if (sq1 == sq2)
-            {
-                continue;
-            }
-            int file1 = sq1 % 8, file2 = sq2 % 8;
-            int rank1 = sq1 / 8, rank2 = sq2 / 8;
-            int dx = file2 - file1, dy = rank2 - rank1;
-            // same file, rank, \ and /
-            if (dx != 0 && dy != 0 && abs(dx) != abs(dy))
-            {
-                continue;
-            }
-            int step_x = (dx == 0) ? 0 : (dx > 0 ? 1 : -1);
-            int step_y = (dy == 0) ? 0 : (dy > 0 ? 1 : -1);
-            int step = step_y * 8 + step_x;
-            int current = sq1 + step;
-            while (current != sq2 && current >= 0 && current < 64)
-            {
-                between[sq1][sq2] |= (1ULL << current);
-                current += step;
-            }
-        }
-    }
-}
@@ -2,29 +2,39 @@
 #define ATTACKS_HPP
 #include "Types.hpp"
 #include "Magics.hpp"
+#include <array>
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
 
-extern Bitboard knight_attacks[64];
-extern Bitboard pawn_attacks[2][64];
-extern Bitboard king_attacks[64];
-extern Bitboard between[64][64];
-
-void init_attacks();
+// Leaper and line tables - computed at compile time (constexpr definitions in Attacks.cpp)
+extern const std::array<Bitboard, 64> knight_attacks;
+extern const std::array<std::array<Bitboard, 64>, 2> pawn_attacks; // [color][square]
+extern const std::array<Bitboard, 64> king_attacks;
+extern const std::array<std::array<Bitboard, 64>, 64> between; // squares strictly between, 0 if not on a line
+extern const std::array<std::array<Bitboard, 64>, 64> line;    // whole line through both squares, 0 if not on a line
 
 // Inline magic bitboard functions
+// Table index of the relevant occupancy: BMI2 PEXT (-DENGINE_PEXT=ON) or magic multiply-shift
+inline uint64_t slider_index(const magics::Magic &m, Bitboard occupied)
+{
+#ifdef USE_PEXT
+    return _pext_u64(occupied, m.mask);
+#else
+    return ((occupied & m.mask) * m.magic) >> m.shift;
+#endif
+}
+
 inline Bitboard get_rook_attacks(int square, Bitboard occupied)
 {
-    occupied &= magics::rook_masks[square];
-    occupied *= magics::rook_magics[square];
-    occupied >>= magics::rook_shifts[square];
-    return magics::rook_attacks[square][occupied];
+    const magics::Magic &m = magics::rook[square];
+    return magics::attacks[m.offset + slider_index(m, occupied)];
 }
 
 inline Bitboard get_bishop_attacks(int square, Bitboard occupied)
 {
-    occupied &= magics::bishop_masks[square];
-    occupied *= magics::bishop_magics[square];
-    occupied >>= magics::bishop_shifts[square];
-    return magics::bishop_attacks[square][occupied];
+    const magics::Magic &m = magics::bishop[square];
+    return magics::attacks[m.offset + slider_index(m, occupied)];
 }
 
 inline Bitboard get_queen_attacks(int square, Bitboard occupied)
@@ -0,0 +1,37 @@
+#include "Bench.hpp"
+#include "FenParser.hpp"
+#include <chrono>
+
+const std::vector<std::string> &bench_positions()
+{
+    static const std::vector<std::string> positions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    };
+    return positions;
+}
+
+BenchResult run_bench(SearchPool &pool, TranspositionTable &table, int depth, const BenchCallback &on_position)
+{
+    BenchResult result;
+    SearchLimits limits;
+    limits.depth = depth;
+    Board board;
+    for (const std::string &fen : bench_positions())
+    {
+        load_fen_position(board, fen);
+        table.clear();
+        auto start = std::chrono::steady_clock::now();
+        Move best = pool.search(board, limits);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.seconds += seconds;
+        result.nodes += pool.get_nodes();
+        if (on_position)
+            on_position(fen, best, seconds);
+    }
+    return result;
+}
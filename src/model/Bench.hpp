@@ -0,0 +1,23 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "SearchPool.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Fixed search benchmark shared by the `bench` tool and the UCI `bench` command
+const std::vector<std::string> &bench_positions();
+
+struct BenchResult
+{
+    long long nodes = 0;
+    double seconds = 0.0;
+};
+
+// Searches every bench position to `depth` from a cleared table.
+// on_position is called after each search with the FEN, best move and time.
+using BenchCallback = std::function<void(const std::string &fen, Move best, double seconds)>;
+BenchResult run_bench(SearchPool &pool, TranspositionTable &table, int depth, const BenchCallback &on_position = nullptr);
+
+#endif
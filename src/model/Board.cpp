@@ -1,22 +1,15 @@
 #include "Board.hpp"
 #include "MoveGenerator.hpp"
 #include "Zobrist.hpp"
+#include "Evaluation.hpp"
 #include "Attacks.hpp"
 #include "FenParser.hpp"
+#include <algorithm>
 #include <sstream>
 
-std::vector<Move> Board::current_legal_moves;
-
 Board::Board()
 {
-    static bool initialized = false;
-    if (!initialized)
-    {
-        init_attacks();
-        init_zobrist();
-
-        initialized = true;
-    }
+    // Attack, Zobrist and evaluation tables are compile-time constants - nothing to initialize
     for (int i = 0; i < 13; i++)
         bitboards[i] = 0ULL;
     for (int i = 0; i < 64; i++)
@@ -34,16 +27,27 @@ void Board::set_bit(int square, int piece)
     // Update board array
     board_arr[square] = piece;
 }
-void Board::make_move(const Move &move, bool update_state)
+void Board::make_move(const Move &move)
 {
-    history.push_back({castling_rights, enpassant_square, halfmove_clock, current_zobrist_key});
-    int source = move.source;
-    int destination = move.target;
+    int previous_castling_rights = castling_rights;
+    GameState &state = history[history_count++ & (HISTORY_SIZE - 1)];
+    check_infos[history_count & (HISTORY_SIZE - 1)].valid = false;
+    // The new position's check info slot is shared with the oldest one - that one is gone now
+    if (history_count - history_floor >= HISTORY_SIZE)
+        history_floor = history_count - (HISTORY_SIZE - 1);
+    state.zobrist_position_key = current_zobrist_key;
+    state.eval_terms = eval_terms;
+    state.halfmove_clock = static_cast<uint16_t>(halfmove_clock);
+    state.castling_rights = static_cast<uint8_t>(castling_rights);
+    state.enpassant_file = enpassant_square ? static_cast<int8_t>(__builtin_ctzll(enpassant_square) % 8) : -1;
+    int source = move.source();
+    int destination = move.target();
     int piece = board_arr[source];
-    int captured = move.captured;
+    int captured = move.captured();
 
     if (piece == EMPTY)
         return;
+    dirty_pieces.count = 0;
 
     // XOR out old enpassant
     if (enpassant_square)
@@ -79,6 +83,7 @@ void Board::make_move(const Move &move, bool update_state)
     Bitboard fromMask = 1ULL << source;
     Bitboard toMask = 1ULL << destination;
     current_zobrist_key ^= piece_keys[piece][source];
+    eval_remove(eval_terms, piece, source);
     bitboards[piece] &= ~fromMask;
     board_arr[source] = EMPTY;
     // Incremental update: remove from source
@@ -88,10 +93,12 @@ void Board::make_move(const Move &move, bool update_state)
     else
         black_pieces ^= fromMask;
 
-    if (captured != EMPTY && move.enpassant == 0)
+    if (captured != EMPTY && move.enpassant() == 0)
     {
         // Remove captured piece
         current_zobrist_key ^= piece_keys[captured][destination];
+        eval_remove(eval_terms, captured, destination);
+        dirty_pieces.add(captured, destination, NO_SQUARE);
         bitboards[captured] &= ~toMask;
         // Incremental update: remove captured
         all_pieces ^= toMask;
@@ -116,10 +123,10 @@ void Board::make_move(const Move &move, bool update_state)
                 castling_rights &= ~0b1000;
         }
     }
-    else if (move.castle != 0)
+    else if (move.castle() != 0)
     {
         // king side
-        if (move.castle == 1)
+        if (move.castle() == 1)
         {
             int rook_src = (piece == WHITE_KING) ? h1 : h8;
             int rook_dst = (piece == WHITE_KING) ? f1 : f8;
@@ -130,6 +137,8 @@ void Board::make_move(const Move &move, bool update_state)
             Bitboard rookTo = 1ULL << rook_dst;
             current_zobrist_key ^= piece_keys[rook_piece][rook_src];
             current_zobrist_key ^= piece_keys[rook_piece][rook_dst];
+            eval_move(eval_terms, rook_piece, rook_src, rook_dst);
+            dirty_pieces.add(rook_piece, rook_src, rook_dst);
             bitboards[rook_piece] ^= rookFrom | rookTo;
             board_arr[rook_src] = EMPTY;
             board_arr[rook_dst] = rook_piece;
@@ -141,7 +150,7 @@ void Board::make_move(const Move &move, bool update_state)
                 black_pieces ^= rookFrom | rookTo;
         }
         // queen side
-        else if (move.castle == 2)
+        else if (move.castle() == 2)
         {
             int rook_src = (piece == WHITE_KING) ? a1 : a8;
             int rook_dst = (piece == WHITE_KING) ? d1 : d8;
@@ -152,6 +161,8 @@ void Board::make_move(const Move &move, bool update_state)
             Bitboard rookTo = 1ULL << rook_dst;
             current_zobrist_key ^= piece_keys[rook_piece][rook_src];
             current_zobrist_key ^= piece_keys[rook_piece][rook_dst];
+            eval_move(eval_terms, rook_piece, rook_src, rook_dst);
+            dirty_pieces.add(rook_piece, rook_src, rook_dst);
             bitboards[rook_piece] ^= rookFrom | rookTo;
             board_arr[rook_src] = EMPTY;
             board_arr[rook_dst] = rook_piece;
@@ -165,8 +176,16 @@ void Board::make_move(const Move &move, bool update_state)
     }
 
     // Place piece at destination
-    int pieceToPlace = (move.promotion != 0) ? move.promotion : piece;
+    int pieceToPlace = (move.promotion() != 0) ? move.promotion() : piece;
     current_zobrist_key ^= piece_keys[pieceToPlace][destination];
+    eval_add(eval_terms, pieceToPlace, destination);
+    if (pieceToPlace == piece)
+        dirty_pieces.add(piece, source, destination);
+    else
+    {
+        dirty_pieces.add(piece, source, NO_SQUARE);
+        dirty_pieces.add(pieceToPlace, NO_SQUARE, destination);
+    }
     bitboards[pieceToPlace] |= toMask;
     board_arr[destination] = pieceToPlace;
     // Incremental update: add to destination
@@ -176,7 +195,7 @@ void Board::make_move(const Move &move, bool update_state)
     else
         black_pieces |= toMask;
     // update  clock moves
-    halfmove_clock = move.captured != 0 ? 0 : halfmove_clock + 1;
+    halfmove_clock = move.captured() != 0 ? 0 : halfmove_clock + 1;
     if (white_to_move == false)
     {
         fullmove_clock++;
@@ -200,6 +219,8 @@ void Board::make_move(const Move &move, bool update_state)
             int captured_pawn_sq = (piece == WHITE_PAWN) ? destination - 8 : destination + 8;
             Bitboard epCapMask = 1ULL << captured_pawn_sq;
             current_zobrist_key ^= piece_keys[captured][captured_pawn_sq];
+            eval_remove(eval_terms, captured, captured_pawn_sq);
+            dirty_pieces.add(captured, captured_pawn_sq, NO_SQUARE);
             bitboards[captured] &= ~epCapMask;
             board_arr[captured_pawn_sq] = EMPTY;
             // Incremental update: remove en passant captured pawn
@@ -214,9 +235,9 @@ void Board::make_move(const Move &move, bool update_state)
     }
 
     // XOR in new castling rights
-    if (castling_rights != history.back().castling_rights)
+    if (castling_rights != previous_castling_rights)
     {
-        current_zobrist_key ^= castling_keys[history.back().castling_rights];
+        current_zobrist_key ^= castling_keys[previous_castling_rights];
         current_zobrist_key ^= castling_keys[castling_rights];
     }
 
@@ -231,27 +252,27 @@ void Board::make_move(const Move &move, bool update_state)
     current_zobrist_key ^= side_key;
 
     white_to_move = !white_to_move;
-    if (update_state)
-        update_game_state();
+    game_state_valid = false;
 }
-void Board::undo_move(const Move &move, bool update_state)
+void Board::undo_move(const Move &move)
 {
 
-    if (history.empty())
+    if (history_count == history_floor)
     {
         return;
     }
-    int source = move.source;
-    int destination = move.target;
+    int source = move.source();
+    int destination = move.target();
     int piece = board_arr[destination];
 
-    GameState last_state = history.back();
-    history.pop_back();
+    const GameState &last_state = history[--history_count & (HISTORY_SIZE - 1)];
     castling_rights = last_state.castling_rights;
-    enpassant_square = last_state.enpassant_square;
     halfmove_clock = last_state.halfmove_clock;
     current_zobrist_key = last_state.zobrist_position_key;
+    eval_terms = last_state.eval_terms;
     white_to_move = !white_to_move;
+    // The en passant square sits behind the pawn the opponent just pushed
+    enpassant_square = last_state.enpassant_file < 0 ? 0ULL : 1ULL << ((white_to_move ? 40 : 16) + last_state.enpassant_file);
     if (!white_to_move)
     {
         fullmove_clock--;
@@ -260,10 +281,10 @@ void Board::undo_move(const Move &move, bool update_state)
     // remove piece
     Bitboard fromMask = 1ULL << source;
     Bitboard toMask = 1ULL << destination;
-    if (move.promotion)
+    if (move.promotion())
     {
         piece = white_to_move ? WHITE_PAWN : BLACK_PAWN;
-        bitboards[move.promotion] &= ~toMask;
+        bitboards[move.promotion()] &= ~toMask;
     }
     else
     {
@@ -288,10 +309,10 @@ void Board::undo_move(const Move &move, bool update_state)
         black_pieces |= fromMask;
 
     // place captured piece
-    if (move.captured != EMPTY && !move.enpassant)
+    if (move.captured() != EMPTY && !move.enpassant())
     {
-        bitboards[move.captured] |= toMask;
-        board_arr[destination] = move.captured;
+        bitboards[move.captured()] |= toMask;
+        board_arr[destination] = move.captured();
         // Incremental update: restore captured
         all_pieces |= toMask;
         if (!white_to_move)
@@ -300,12 +321,12 @@ void Board::undo_move(const Move &move, bool update_state)
             black_pieces |= toMask;
     }
     // enpasant
-    if (move.enpassant)
+    if (move.enpassant())
     {
         int captured_sq = (white_to_move ? destination - 8 : destination + 8);
         Bitboard epMask = 1ULL << captured_sq;
-        bitboards[move.captured] |= epMask;
-        board_arr[captured_sq] = move.captured;
+        bitboards[move.captured()] |= epMask;
+        board_arr[captured_sq] = move.captured();
         // Incremental update: restore en passant captured
         all_pieces |= epMask;
         if (!white_to_move)
@@ -314,11 +335,11 @@ void Board::undo_move(const Move &move, bool update_state)
             black_pieces |= epMask;
     }
     // casting
-    if (move.castle)
+    if (move.castle())
     {
         int rook_dst, rook_src, rook_piece = white_to_move ? WHITE_ROOK : BLACK_ROOK;
 
-        if (move.castle == 1)
+        if (move.castle() == 1)
         {
             rook_dst = (white_to_move ? f1 : f8);
             rook_src = (white_to_move ? h1 : h8);
@@ -341,8 +362,7 @@ void Board::undo_move(const Move &move, bool update_state)
         else
             black_pieces ^= rookFrom | rookTo;
     }
-    if (update_state)
-        update_game_state();
+    game_state_valid = false;
 }
 // tbi update only changed squares
 void Board::update_bitboards()
@@ -361,29 +381,30 @@ void Board::update_bitboards()
     }
     all_pieces = white_pieces | black_pieces;
 }
-Bitboard Board::get_attackers(int square, bool white_attacker)
+template <Color Attacker>
+Bitboard Board::get_attackers(int square)
 {
     Bitboard attackers = 0ULL;
-    // Pawns using black lookup table
-    attackers |= (pawn_attacks[white_attacker ? 1 : 0][square] & bitboards[white_attacker ? WHITE_PAWN : BLACK_PAWN]);
+    // Pawns using opposite color lookup table
+    attackers |= (pawn_attacks[opposite(Attacker)][square] & bitboards[make_piece(Attacker, PAWN)]);
 
     // Knights
-    attackers |= (knight_attacks[square] & bitboards[white_attacker ? WHITE_KNIGHT : BLACK_KNIGHT]);
+    attackers |= (knight_attacks[square] & bitboards[make_piece(Attacker, KNIGHT)]);
 
     // King
-    attackers |= (king_attacks[square] & bitboards[white_attacker ? WHITE_KING : BLACK_KING]);
+    attackers |= (king_attacks[square] & bitboards[make_piece(Attacker, KING)]);
 
     // Sliding pieces (Bishops/Queens)
-    Bitboard bishops_queens = bitboards[white_attacker ? WHITE_BISHOP : BLACK_BISHOP] |
-                              bitboards[white_attacker ? WHITE_QUEEN : BLACK_QUEEN];
+    Bitboard bishops_queens = bitboards[make_piece(Attacker, BISHOP)] |
+                              bitboards[make_piece(Attacker, QUEEN)];
     if (bishops_queens)
     {
         attackers |= (get_bishop_attacks(square, all_pieces) & bishops_queens);
     }
 
     // Sliding pieces (Rooks/Queens)
-    Bitboard rooks_queens = bitboards[white_attacker ? WHITE_ROOK : BLACK_ROOK] |
-                            bitboards[white_attacker ? WHITE_QUEEN : BLACK_QUEEN];
+    Bitboard rooks_queens = bitboards[make_piece(Attacker, ROOK)] |
+                            bitboards[make_piece(Attacker, QUEEN)];
     if (rooks_queens)
     {
         attackers |= (get_rook_attacks(square, all_pieces) & rooks_queens);
@@ -391,71 +412,248 @@ Bitboard Board::get_attackers(int square, bool white_attacker)
 
     return attackers;
 }
-
-Bitboard Board::get_check_mask(bool white_to_move)
+Bitboard Board::get_attackers(int square, bool white_attacker)
 {
-    int king_sq = __builtin_ctzll(bitboards[white_to_move ? WHITE_KING : BLACK_KING]);
-
-    Bitboard attackers = get_attackers(king_sq, !white_to_move);
+    return white_attacker ? get_attackers<WHITE>(square) : get_attackers<BLACK>(square);
+}
 
-    int count = __builtin_popcountll(attackers);
+template <Color Us>
+Bitboard Board::get_check_mask()
+{
+    Bitboard checkers = get_check_info<Us, false>().checkers;
 
     // No check -> can move anywhere
-    if (count == 0)
+    if (!checkers)
         return ~0ULL;
 
     // Double check -> only king can move
-    if (count > 1)
+    if (checkers & (checkers - 1))
         return 0ULL;
 
-    // Single check -> must capture attacker OR block the line
-    int attacker_sq = __builtin_ctzll(attackers);
+    // Single check -> must capture the checker or block the line
+    int king_sq = __builtin_ctzll(bitboards[make_piece(Us, KING)]);
+    return between[king_sq][__builtin_ctzll(checkers)] | checkers;
+}
+
+// Pieces of either color standing alone between the Us king and a Them slider
+template <Color Us>
+Bitboard Board::get_slider_blockers(int king_sq)
+{
+    constexpr Color Them = opposite(Us);
+    Bitboard rooks_queens = bitboards[make_piece(Them, ROOK)] | bitboards[make_piece(Them, QUEEN)];
+    Bitboard bishops_queens = bitboards[make_piece(Them, BISHOP)] | bitboards[make_piece(Them, QUEEN)];
+    Bitboard snipers = (get_rook_attacks(king_sq, 0) & rooks_queens) | (get_bishop_attacks(king_sq, 0) & bishops_queens);
 
-    // Mask is: squares between king and attacker OR the attacker square itself
-    return between[king_sq][attacker_sq] | (1ULL << attacker_sq);
+    Bitboard blockers = 0ULL;
+    while (snipers)
+    {
+        Bitboard path = between[king_sq][__builtin_ctzll(snipers)] & all_pieces;
+        if (path && !(path & (path - 1)))
+            blockers |= path;
+        snipers &= snipers - 1;
+    }
+    return blockers;
 }
-// repetetive code
-void Board::get_pin_masks(bool white_to_move, Bitboard *pin_masks)
+
+template <Color Us>
+void Board::update_check_info(CheckInfo &info)
 {
-    int king_sq = __builtin_ctzll(bitboards[white_to_move ? WHITE_KING : BLACK_KING]);
-    Bitboard my_pieces = white_to_move ? white_pieces : black_pieces;
-    Bitboard op_rooks = bitboards[white_to_move ? BLACK_ROOK : WHITE_ROOK] | bitboards[white_to_move ? BLACK_QUEEN : WHITE_QUEEN];
-    Bitboard op_bishops = bitboards[white_to_move ? BLACK_BISHOP : WHITE_BISHOP] | bitboards[white_to_move ? BLACK_QUEEN : WHITE_QUEEN];
+    int king_sq = __builtin_ctzll(bitboards[make_piece(Us, KING)]);
+    info.checkers = get_attackers<opposite(Us)>(king_sq);
+    info.blockers[Us] = get_slider_blockers<Us>(king_sq);
+    info.pinned[Us] = info.blockers[Us] & (Us == WHITE ? white_pieces : black_pieces);
+    info.valid = true;
+    info.complete = false;
+}
 
-    Bitboard pinner_candidates = get_rook_attacks(king_sq, 0) & op_rooks;
+template <Color Us>
+void Board::complete_check_info(CheckInfo &info)
+{
+    constexpr Color Them = opposite(Us);
+    int their_king_sq = __builtin_ctzll(bitboards[make_piece(Them, KING)]);
+    info.blockers[Them] = get_slider_blockers<Them>(their_king_sq);
+    info.pinned[Them] = info.blockers[Them] & (Them == WHITE ? white_pieces : black_pieces);
+
+    info.check_squares[EMPTY] = 0ULL;
+    info.check_squares[PAWN] = pawn_attacks[Them][their_king_sq];
+    info.check_squares[KNIGHT] = knight_attacks[their_king_sq];
+    info.check_squares[BISHOP] = get_bishop_attacks(their_king_sq, all_pieces);
+    info.check_squares[ROOK] = get_rook_attacks(their_king_sq, all_pieces);
+    info.check_squares[QUEEN] = info.check_squares[BISHOP] | info.check_squares[ROOK];
+    info.check_squares[KING] = 0ULL;
+    info.complete = true;
+}
 
-    while (pinner_candidates)
+template Bitboard Board::get_attackers<WHITE>(int square);
+template Bitboard Board::get_attackers<BLACK>(int square);
+template Bitboard Board::get_check_mask<WHITE>();
+template Bitboard Board::get_check_mask<BLACK>();
+template void Board::update_check_info<WHITE>(CheckInfo &info);
+template void Board::update_check_info<BLACK>(CheckInfo &info);
+template void Board::complete_check_info<WHITE>(CheckInfo &info);
+template void Board::complete_check_info<BLACK>(CheckInfo &info);
+
+template <Color Us>
+bool Board::is_pseudo_legal(const Move &move)
+{
+    constexpr Color Them = opposite(Us);
+    int source = move.source();
+    int target = move.target();
+    int piece = move.piece();
+    int captured = move.captured();
+    int promotion = move.promotion();
+    Bitboard target_mask = 1ULL << target;
+
+    // Unused bits set, or not our piece on the source square
+    if ((move.data >> 27) || piece == EMPTY || piece != board_arr[source] || is_white_piece(piece) != (Us == WHITE))
+        return false;
+    int type = Us == WHITE ? piece : piece - 6;
+
+    if (move.castle())
     {
-        int pinner_sq = __builtin_ctzll(pinner_candidates);
-        Bitboard path = between[king_sq][pinner_sq];
-        Bitboard pinned = path & all_pieces;
-        // was __builtin_popcountll(pinned) == 1
-        if (pinned && !(pinned & (pinned - 1)) && (pinned & my_pieces))
-        {
-            int pinned_sq = __builtin_ctzll(pinned);
-            // Movement mask for this piece is the attack line (including pinner)
-            pin_masks[pinned_sq] = path | (1ULL << pinner_sq);
-        }
-        pinner_candidates &= pinner_candidates - 1;
+        constexpr int king_sq = Us == WHITE ? e1 : e8;
+        constexpr int king_side_right = Us == WHITE ? 0b0001 : 0b0100;
+        constexpr int queen_side_right = Us == WHITE ? 0b0010 : 0b1000;
+        if (type != KING || source != king_sq || captured || promotion || move.enpassant())
+            return false;
+        if (move.castle() == 1)
+            return target == king_sq + 2 && (castling_rights & king_side_right) &&
+                   board_arr[king_sq + 1] == EMPTY && board_arr[king_sq + 2] == EMPTY;
+        return target == king_sq - 2 && (castling_rights & queen_side_right) &&
+               board_arr[king_sq - 1] == EMPTY && board_arr[king_sq - 2] == EMPTY && board_arr[king_sq - 3] == EMPTY;
+    }
+    if (move.enpassant())
+        return type == PAWN && enpassant_square == target_mask && captured == make_piece(Them, PAWN) && !promotion &&
+               (pawn_attacks[Them][target] & (1ULL << source));
+
+    // The captured piece must be what stands on the target square (EMPTY for quiet moves)
+    if (captured != board_arr[target] || ((Us == WHITE ? white_pieces : black_pieces) & target_mask))
+        return false;
+
+    // Pawns reaching the last rank must promote, nothing else may
+    constexpr Bitboard promotion_rank = Us == WHITE ? RANK_8 : RANK_1;
+    if (type == PAWN && (target_mask & promotion_rank))
+    {
+        if (promotion < make_piece(Us, KNIGHT) || promotion > make_piece(Us, QUEEN))
+            return false;
+    }
+    else if (promotion)
+        return false;
+
+    switch (type)
+    {
+    case PAWN:
+    {
+        constexpr int up = Us == WHITE ? 8 : -8;
+        constexpr Bitboard start_rank = Us == WHITE ? RANK_1 << 8 : RANK_1 << 48;
+        if (captured)
+            return pawn_attacks[Us][source] & target_mask;
+        if (target == source + up)
+            return true;
+        return target == source + 2 * up && ((1ULL << source) & start_rank) && board_arr[source + up] == EMPTY;
+    }
+    case KNIGHT:
+        return knight_attacks[source] & target_mask;
+    case BISHOP:
+        return get_bishop_attacks(source, all_pieces) & target_mask;
+    case ROOK:
+        return get_rook_attacks(source, all_pieces) & target_mask;
+    case QUEEN:
+        return get_queen_attacks(source, all_pieces) & target_mask;
+    default:
+        return king_attacks[source] & target_mask;
+    }
+}
+
+// Same rules as the generator: pins and the check mask for most pieces, attacked squares for the king
+template <Color Us>
+bool Board::is_legal(const Move &move)
+{
+    constexpr Color Them = opposite(Us);
+    int source = move.source();
+    int target = move.target();
+
+    if (move.castle())
+    {
+        // The king may not start on, pass or land on an attacked square
+        int passed = (source + target) / 2;
+        return !is_square_attacked<Them>(source) && !is_square_attacked<Them>(passed) && !is_square_attacked<Them>(target);
+    }
+    if (move.piece() == make_piece(Us, KING))
+    {
+        // Without the king on the board, so it does not hide a slider's ray behind itself
+        Bitboard saved_all_pieces = all_pieces;
+        all_pieces &= ~(1ULL << source);
+        bool safe = !is_square_attacked<Them>(target);
+        all_pieces = saved_all_pieces;
+        return safe;
+    }
+    if (move.enpassant())
+    {
+        // Two pawns leave the king's rank at once - played out, like the generator does
+        make_move(move);
+        bool safe = !is_in_check<Us>();
+        undo_move(move);
+        return safe;
     }
 
-    pinner_candidates = get_bishop_attacks(king_sq, 0) & op_bishops;
+    Bitboard target_mask = 1ULL << target;
+    if (!(get_check_mask<Us>() & target_mask))
+        return false;
+    // A pinned piece has to stay on the line through its king
+    int king_sq = __builtin_ctzll(bitboards[make_piece(Us, KING)]);
+    return !(get_check_info<Us, false>().pinned[Us] & (1ULL << source)) || (line[king_sq][source] & target_mask);
+}
 
-    while (pinner_candidates)
+template <Color Us>
+bool Board::gives_check(const Move &move)
+{
+    constexpr Color Them = opposite(Us);
+    // Rook and king both move, or two pawns leave the board - played out
+    if (move.castle() || move.enpassant())
     {
-        int pinner_sq = __builtin_ctzll(pinner_candidates);
-        Bitboard path = between[king_sq][pinner_sq];
-        Bitboard pinned = path & all_pieces;
+        make_move(move);
+        bool check = is_in_check<Them>();
+        undo_move(move);
+        return check;
+    }
 
-        if (__builtin_popcountll(pinned) == 1 && (pinned & my_pieces))
-        {
-            int pinned_sq = __builtin_ctzll(pinned);
-            pin_masks[pinned_sq] = path | (1ULL << pinner_sq);
-        }
-        pinner_candidates &= pinner_candidates - 1;
+    const CheckInfo &info = get_check_info<Us>();
+    int source = move.source();
+    int target = move.target();
+    Bitboard target_mask = 1ULL << target;
+    int their_king_sq = __builtin_ctzll(bitboards[make_piece(Them, KING)]);
+
+    // Discovered check: a blocker of their king leaves the line
+    if ((info.blockers[Them] & (1ULL << source)) && !(line[their_king_sq][source] & target_mask))
+        return true;
+
+    if (!move.promotion())
+        return info.check_squares[Us == WHITE ? move.piece() : move.piece() - 6] & target_mask;
+
+    // The promoted piece's rays may pass through the square the pawn just left
+    Bitboard occupied = all_pieces ^ (1ULL << source);
+    Bitboard their_king = 1ULL << their_king_sq;
+    switch (Us == WHITE ? move.promotion() : move.promotion() - 6)
+    {
+    case KNIGHT:
+        return knight_attacks[target] & their_king;
+    case BISHOP:
+        return get_bishop_attacks(target, occupied) & their_king;
+    case ROOK:
+        return get_rook_attacks(target, occupied) & their_king;
+    default:
+        return get_queen_attacks(target, occupied) & their_king;
     }
 }
 
+template bool Board::is_pseudo_legal<WHITE>(const Move &move);
+template bool Board::is_pseudo_legal<BLACK>(const Move &move);
+template bool Board::is_legal<WHITE>(const Move &move);
+template bool Board::is_legal<BLACK>(const Move &move);
+template bool Board::gives_check<WHITE>(const Move &move);
+template bool Board::gives_check<BLACK>(const Move &move);
+
 bool Board::has_insufficient_material()
 {
     // If there are any pawns, rooks, or queens, it's not insufficient material
@@ -488,10 +686,11 @@ bool Board::has_insufficient_material()
 bool Board::is_repetition()
 {
     int count = 1;
-    int history_size = history.size();
-    for (int i = history_size - 2; i >= 0 && i >= history_size - halfmove_clock; i -= 2)
+    // Game moves and search plies share the stack, so this also sees positions from before the root
+    int oldest = std::max({0, history_count - halfmove_clock, history_count - HISTORY_SIZE});
+    for (int i = history_count - 2; i >= oldest; i -= 2)
     {
-        if (history[i].zobrist_position_key == current_zobrist_key)
+        if (history[i & (HISTORY_SIZE - 1)].zobrist_position_key == current_zobrist_key)
         {
             count++;
             if (count >= 3)
@@ -503,48 +702,49 @@ bool Board::is_repetition()
 
 void Board::update_game_state()
 {
-    current_legal_moves = MoveGenerator::generate_moves(*this);
+    MoveGenerator::generate_moves(*this, legal_moves);
+    game_state_valid = true;
 
     // 1. 50-move rule
     if (halfmove_clock >= 100)
     {
-        current_game_status = DRAW;
+        game_status = DRAW;
         return;
     }
 
     // 2. Insufficient material
     if (has_insufficient_material())
     {
-        current_game_status = DRAW;
+        game_status = DRAW;
         return;
     }
 
     // 3. Threefold repetition
     if (is_repetition())
     {
-        current_game_status = DRAW;
+        game_status = DRAW;
         return;
     }
 
     // 4. Checkmate / Stalemate
-    if (current_legal_moves.empty())
+    if (legal_moves.empty())
     {
         if (is_in_check(white_to_move))
         {
-            current_game_status = white_to_move ? BLACK_WON : WHITE_WON;
+            game_status = white_to_move ? BLACK_WON : WHITE_WON;
         }
         else
         {
-            current_game_status = DRAW;
+            game_status = DRAW;
         }
     }
     else
     {
-        current_game_status = ONGOING;
+        game_status = ONGOING;
     }
 }
 void Board::reset_game()
 {
-    current_game_status = ONGOING;
+    game_status = ONGOING;
     load_fen_position(*this, starting_fen);
 }
\ No newline at end of file
@@ -1,67 +1,126 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
+#include <cassert>
 #include <string>
-#include <vector>
 #include "Types.hpp"
 #include "Attacks.hpp"
+#include "MoveList.hpp"
 
 class MoveGenerator;
 
-class Board
+// Everything that describes one position, in 256 trivially copyable bytes. Search and perft
+// save it once per node and restore it after each move (copy-make) instead of undo_move.
+struct alignas(64) Position
 {
-    friend class MoveGenerator;
-    friend void load_fen_position(Board &board, const std::string &fen);
-    friend uint64_t hash_position(Board &board);
-
-private:
     // Bitboard representation empty on 0, pieces 1-12
     Bitboard bitboards[13];
-    int board_arr[64];
-
     // Additional bitboards
     Bitboard
-        white_pieces, // 1-5
-        black_pieces, // 6-12
+        white_pieces, // 1-6
+        black_pieces, // 7-12
         all_pieces,
         enpassant_square;
-    void update_bitboards();
+    uint64_t current_zobrist_key;
+    int8_t board_arr[64];
+    EvalTerms eval_terms;
     int castling_rights; // bit 0: white king-side, bit 1: white queen-side, bit 2: black king-side, bit 3: black queen-side
+    int halfmove_clock = 0;
+    int fullmove_clock = 1;
+    bool white_to_move;
+};
+static_assert(sizeof(Position) == 256, "Position should stay four cache lines");
 
-    inline bool is_square_attacked(int square, bool by_white)
+// Capacity of the state stack - one entry per move played, game moves and search plies alike.
+// Repetitions reach back at most 100 plies (50-move rule) and the search adds at most MAX_PLY,
+// so only moves older than that are overwritten. Once the ring wraps, undo_move and
+// restore_position can step back at most HISTORY_SIZE - 1 moves (see history_floor).
+constexpr int HISTORY_SIZE = 256;
+static_assert((HISTORY_SIZE & (HISTORY_SIZE - 1)) == 0, "HISTORY_SIZE must be a power of two");
+
+// Check and pin data of one position, for the side to move (Us) and the opponent (Them).
+// Computed on first request and kept on the state stack, so the parent's copy is still
+// valid after undo_move / restore_position. Move generation only needs checkers and
+// pinned[Us]; the rest is filled in when SEE or gives_check first asks for it.
+struct CheckInfo
+{
+    Bitboard checkers;         // Them pieces giving check to the side to move
+    Bitboard blockers[2];      // [Color] pieces of either color that alone shield that king from a slider
+    Bitboard pinned[2];        // [Color] blockers of that color - they may only move along line[king][square]
+    Bitboard check_squares[7]; // [PieceType] squares from which an Us piece of that type checks the Them king
+    bool valid;                // checkers, blockers[Us], pinned[Us] are set
+    bool complete;             // all fields are set
+};
+
+class Board : private Position
+{
+    friend class MoveGenerator;
+    friend void load_fen_position(Board &board, const std::string &fen);
+    friend uint64_t hash_position(Board &board);
+
+private:
+    void update_bitboards();
+
+    // Color-specialized attack test - all piece indices fold at compile time
+    template <Color Attacker>
+    inline bool is_square_attacked(int square)
     {
-        // Pawn attacks
-        if (pawn_attacks[by_white ? 1 : 0][square] & bitboards[by_white ? WHITE_PAWN : BLACK_PAWN])
+        // Pawn attacks (squares attacked by Attacker pawns = opposite pawn pattern from square)
+        if (pawn_attacks[opposite(Attacker)][square] & bitboards[make_piece(Attacker, PAWN)])
             return true;
         // Knight attacks
-        if (knight_attacks[square] & bitboards[by_white ? WHITE_KNIGHT : BLACK_KNIGHT])
+        if (knight_attacks[square] & bitboards[make_piece(Attacker, KNIGHT)])
             return true;
         // King attacks
-        if (king_attacks[square] & bitboards[by_white ? WHITE_KING : BLACK_KING])
+        if (king_attacks[square] & bitboards[make_piece(Attacker, KING)])
             return true;
         // Bishop/Queen attacks (diagonal)
-        Bitboard bishops_queens = bitboards[by_white ? WHITE_BISHOP : BLACK_BISHOP] | bitboards[by_white ? WHITE_QUEEN : BLACK_QUEEN];
+        Bitboard bishops_queens = bitboards[make_piece(Attacker, BISHOP)] | bitboards[make_piece(Attacker, QUEEN)];
         if (get_bishop_attacks(square, all_pieces) & bishops_queens)
             return true;
         // Rook/Queen attacks (straight)
-        Bitboard rooks_queens = bitboards[by_white ? WHITE_ROOK : BLACK_ROOK] | bitboards[by_white ? WHITE_QUEEN : BLACK_QUEEN];
+        Bitboard rooks_queens = bitboards[make_piece(Attacker, ROOK)] | bitboards[make_piece(Attacker, QUEEN)];
         if (get_rook_attacks(square, all_pieces) & rooks_queens)
             return true;
         return false;
     }
+    inline bool is_square_attacked(int square, bool by_white)
+    {
+        return by_white ? is_square_attacked<WHITE>(square) : is_square_attacked<BLACK>(square);
+    }
 
+    template <Color Us>
+    inline bool is_in_check()
+    {
+        int king_square = __builtin_ctzll(bitboards[make_piece(Us, KING)]);
+        return is_square_attacked<opposite(Us)>(king_square);
+    }
     inline bool is_in_check(bool white_to_move)
     {
-        int king_square = __builtin_ctzll(bitboards[white_to_move ? WHITE_KING : BLACK_KING]);
-        return is_square_attacked(king_square, !white_to_move);
+        return white_to_move ? is_in_check<WHITE>() : is_in_check<BLACK>();
     }
+    template <Color Us>
+    Bitboard get_slider_blockers(int king_square);
+    template <Color Us>
+    void update_check_info(CheckInfo &info);
+    template <Color Us>
+    void complete_check_info(CheckInfo &info);
+    template <Color Us>
+    bool is_pseudo_legal(const Move &move);
+    template <Color Us>
+    bool is_legal(const Move &move);
+    template <Color Us>
+    bool gives_check(const Move &move);
     // Game state
-    bool white_to_move;
-    int halfmove_clock = 0;
-    int fullmove_clock = 1;
-    std::vector<GameState> history;
-    uint64_t current_zobrist_key;
-    static std::vector<Move> current_legal_moves;
-    Status current_game_status;
+    // Ring indexed by ply - allocated with the board, so make_move never allocates
+    GameState history[HISTORY_SIZE];
+    int history_count = 0; // moves on the stack, entry i lives at i & (HISTORY_SIZE - 1)
+    int history_floor = 0; // lowest history_count still restorable - raised once the ring wraps
+    CheckInfo check_infos[HISTORY_SIZE]; // same indexing, entry history_count = current position
+    DirtyPieces dirty_pieces;
+    // Legal moves and result of the current position - computed on first request after a change
+    MoveList legal_moves;
+    Status game_status = ONGOING;
+    bool game_state_valid = false;
     void update_game_state();
 
 public:
@@ -73,15 +132,74 @@ public:
         return board_arr[pos];
     }
     std::string export_fen_position(); // tbi
-    void make_move(const Move &move, bool update_state = true);
-    void undo_move(const Move &move, bool update_state = true);
+    void make_move(const Move &move);
+    // Takes back the last make_move; a no-op once history_floor is reached (start position,
+    // or HISTORY_SIZE - 1 moves back after the ring wrapped) - not meant for game take-backs
+    void undo_move(const Move &move);
+    // Copy-make: save before make_move, restore instead of undo_move - same depth limit
+    const Position &get_position() const { return *this; }
+    inline void restore_position(const Position &position)
+    {
+        assert(history_count > history_floor);
+        static_cast<Position &>(*this) = position;
+        history_count--;
+        game_state_valid = false;
+    }
     void set_bit(int square, int piece);
     bool is_white_to_move() const { return white_to_move; }
-    Bitboard get_check_mask(bool white_to_move);
-    void get_pin_masks(bool white_to_move, Bitboard *pin_masks);
+    bool in_check() { return is_in_check(white_to_move); }
+    int get_halfmove_clock() const { return halfmove_clock; }
+    Bitboard get_bitboard(int piece) const { return bitboards[piece]; }
+    Bitboard get_occupancy() const { return all_pieces; }
+    Bitboard get_pieces(Color color) const { return color == WHITE ? white_pieces : black_pieces; }
+    uint64_t get_zobrist_key() const { return current_zobrist_key; }
+    const EvalTerms &get_eval_terms() const { return eval_terms; }
+    // Pieces changed by the last make_move (not restored by undo_move)
+    const DirtyPieces &get_dirty_pieces() const { return dirty_pieces; }
+    // Tapered material + piece-square score from the side to move's point of view - O(1)
+    inline int evaluate() const
+    {
+        int phase = eval_terms.phase < MAX_PHASE ? eval_terms.phase : MAX_PHASE;
+        int score = (eval_terms.mg * phase + eval_terms.eg * (MAX_PHASE - phase)) / MAX_PHASE;
+        return white_to_move ? score : -score;
+    }
+    // Complete = false: only the move generator's part (checkers, blockers[Us], pinned[Us]) is set
+    template <Color Us, bool Complete = true>
+    const CheckInfo &get_check_info()
+    {
+        CheckInfo &info = check_infos[history_count & (HISTORY_SIZE - 1)];
+        if (!info.valid)
+            update_check_info<Us>(info);
+        if (Complete && !info.complete)
+            complete_check_info<Us>(info);
+        return info;
+    }
+    const CheckInfo &get_check_info() { return white_to_move ? get_check_info<WHITE>() : get_check_info<BLACK>(); }
+    // Squares that resolve a check: anywhere if not in check, nothing (king moves only) in double check
+    template <Color Us>
+    Bitboard get_check_mask();
+    template <Color Attacker>
+    Bitboard get_attackers(int square);
     Bitboard get_attackers(int square, bool white_attacker);
-    Status get_game_status() const { return current_game_status; }
-    const std::vector<Move> &get_legal_moves() const { return current_legal_moves; }
+    Status get_game_status()
+    {
+        if (!game_state_valid)
+            update_game_state();
+        return game_status;
+    }
+    const MoveList &get_legal_moves()
+    {
+        if (!game_state_valid)
+            update_game_state();
+        return legal_moves;
+    }
+    // Validation of a move from elsewhere (hash move, killers) without generating a move list.
+    // is_pseudo_legal: encoded exactly as generate_moves would encode it here, king safety aside.
+    // is_legal: a pseudo-legal move does not leave the own king in check.
+    bool is_pseudo_legal(const Move &move) { return white_to_move ? is_pseudo_legal<WHITE>(move) : is_pseudo_legal<BLACK>(move); }
+    bool is_legal(const Move &move) { return white_to_move ? is_legal<WHITE>(move) : is_legal<BLACK>(move); }
+    // Whether a legal move checks the opponent, from the cached check squares and blockers
+    bool gives_check(const Move &move) { return white_to_move ? gives_check<WHITE>(move) : gives_check<BLACK>(move); }
     bool has_insufficient_material();
     bool is_repetition();
     void reset_game();
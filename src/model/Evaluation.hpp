@@ -0,0 +1,36 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "Board.hpp"
+#include <array>
+
+// Material + piece-square values per piece and square (PeSTO), already signed:
+// white pieces positive, black pieces negative - indexed [piece][square], built at compile time
+extern const std::array<std::array<int, 64>, 13> mg_table;
+extern const std::array<std::array<int, 64>, 13> eg_table;
+// Game phase contribution per piece (knight/bishop 1, rook 2, queen 4)
+extern const int phase_weight[13];
+
+// Full recompute from board_arr - only for verifying the incremental terms
+EvalTerms compute_eval_terms(Board &board);
+
+// Incremental updates used by make_move
+inline void eval_add(EvalTerms &terms, int piece, int square)
+{
+    terms.mg += mg_table[piece][square];
+    terms.eg += eg_table[piece][square];
+    terms.phase += phase_weight[piece];
+}
+inline void eval_remove(EvalTerms &terms, int piece, int square)
+{
+    terms.mg -= mg_table[piece][square];
+    terms.eg -= eg_table[piece][square];
+    terms.phase -= phase_weight[piece];
+}
+inline void eval_move(EvalTerms &terms, int piece, int from, int to)
+{
+    terms.mg += mg_table[piece][to] - mg_table[piece][from];
+    terms.eg += eg_table[piece][to] - eg_table[piece][from];
+}
+
+#endif
@@ -1,10 +1,13 @@
 #include "FenParser.hpp"
 #include "Board.hpp"
+#include "Evaluation.hpp"
 #include <sstream>
 
 void load_fen_position(Board &board, const std::string &fen)
 {
-    board.history.clear();
+    board.history_count = 0;
+    board.history_floor = 0;
+    board.check_infos[0].valid = false;
     for (int i = 0; i < 13; i++)
         board.bitboards[i] = 0ULL;
     for (int i = 0; i < 64; i++)
@@ -92,6 +95,7 @@ void load_fen_position(Board &board, const std::string &fen)
     board.fullmove_clock = full_clock;
 
     board.update_bitboards();
-    board.update_game_state();
+    board.game_state_valid = false;
     board.current_zobrist_key = hash_position(board);
+    board.eval_terms = compute_eval_terms(board);
 }
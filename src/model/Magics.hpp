@@ -2,22 +2,26 @@
 #define MAGICS_HPP
 
 #include "Types.hpp"
+#include <cstdint>
+
 namespace magics
 {
-    // Shifts and magics for plain magic bitboards. Definitions in Magics.cpp.
-    extern const int rook_shifts[64];
-    extern const int bishop_shifts[64];
-
-    extern const Bitboard rook_magics[64];
-    extern const Bitboard bishop_magics[64];
+    // Fancy magic bitboards - everything a lookup needs for one square in 24 bytes.
+    // Definitions in Magics.cpp (generated by tools/magic_generator.cpp).
+    struct Magic
+    {
+        Bitboard mask;   // relevant occupancy bits (excluding edges)
+        Bitboard magic;  // unused by PEXT builds
+        uint32_t offset; // start of this square's table in `attacks`
+        uint32_t shift;  // 64 - relevant bits
+    };
 
-    // Masks for relevant occupancy bits (excluding edges)
-    extern const Bitboard rook_masks[64];
-    extern const Bitboard bishop_masks[64];
+    extern const Magic rook[64];
+    extern const Magic bishop[64];
 
-    // Plain attack tables: rook_attacks[sq][index], bishop_attacks[sq][index]
-    extern const Bitboard rook_attacks[64][4096];
-    extern const Bitboard bishop_attacks[64][512];
+    // Per-square tables of 1 << relevant bits entries, packed back to back (about 840 KB
+    // instead of 2.3 MB for fixed [64][4096] + [64][512] arrays)
+    extern const Bitboard attacks[];
 }
 
 #endif
@@ -1,121 +1,146 @@
 #include "MoveGenerator.hpp"
 #include "Attacks.hpp"
-#include <cstring>
 
-std::vector<Move> MoveGenerator::generate_moves(Board &board)
+void MoveGenerator::generate_moves(Board &board, MoveList &moves)
 {
-    std::vector<Move> moves;
-    moves.reserve(256);
-    Bitboard pin_mask[64];
-    memset(pin_mask, 0xFF, sizeof(pin_mask));
-    board.get_pin_masks(board.white_to_move, pin_mask);
-    Bitboard check_mask = board.get_check_mask(board.white_to_move);
-    generate_king_moves(board, moves);
-    generate_pawn_moves(board, moves, check_mask, pin_mask);
-    generate_knight_moves(board, moves, check_mask, pin_mask);
-    generate_sliding_moves(board, moves, check_mask, pin_mask);
-    return moves;
+    generate<ALL>(board, moves);
 }
-void MoveGenerator::generate_pawn_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks)
+void MoveGenerator::generate_captures(Board &board, MoveList &moves)
 {
-    bool white_to_move = board.white_to_move;
-    int pawn_type = white_to_move ? WHITE_PAWN : BLACK_PAWN;
+    generate<CAPTURES>(board, moves);
+}
+void MoveGenerator::generate_quiets(Board &board, MoveList &moves)
+{
+    generate<QUIETS>(board, moves);
+}
+template <GenType Type>
+void MoveGenerator::generate(Board &board, MoveList &moves)
+{
+    if (board.white_to_move)
+        generate_moves<WHITE, Type>(board, moves);
+    else
+        generate_moves<BLACK, Type>(board, moves);
+}
+template <Color Us, GenType Type>
+void MoveGenerator::generate_moves(Board &board, MoveList &moves)
+{
+    moves.clear();
+    // Pinned pieces stay on the line through their king (line[king][square])
+    Pins pins{board.get_check_info<Us, false>().pinned[Us], __builtin_ctzll(board.bitboards[make_piece(Us, KING)])};
+    Bitboard check_mask = board.get_check_mask<Us>();
+
+    // Piece targets for this generation type (pawns and the king handle their own)
+    Bitboard own_pieces_mask = Us == WHITE ? board.white_pieces : board.black_pieces;
+    Bitboard enemy_pieces_mask = Us == WHITE ? board.black_pieces : board.white_pieces;
+    Bitboard targets = Type == CAPTURES ? enemy_pieces_mask : Type == QUIETS ? ~board.all_pieces : ~own_pieces_mask;
+    targets &= check_mask;
+
+    generate_king_moves<Us, Type>(board, moves);
+    generate_pawn_moves<Us, Type>(board, moves, check_mask, pins);
+    generate_knight_moves<Us>(board, moves, targets, pins);
+    generate_sliding_moves<Us>(board, moves, targets, pins);
+}
+// Set-wise pawn generation: all pushes and captures are computed for every pawn at once
+// with shifts, then serialized. Pins are applied per target via the source square's pin line.
+template <Color Us, GenType Type>
+void MoveGenerator::generate_pawn_moves(Board &board, MoveList &moves, Bitboard check_mask, const Pins &pins)
+{
+    constexpr Color Them = opposite(Us);
+    constexpr int pawn_type = make_piece(Us, PAWN);
+    constexpr int up = Us == WHITE ? 8 : -8;
+    constexpr int up_left = Us == WHITE ? 7 : -9;
+    constexpr int up_right = Us == WHITE ? 9 : -7;
+    constexpr Bitboard double_push_rank = Us == WHITE ? RANK_3 : RANK_6; // rank after first step
+
     Bitboard pawns_mask = board.bitboards[pawn_type];
-    Bitboard enemy_pieces_mask = white_to_move ? board.black_pieces : board.white_pieces;
-    int direction = white_to_move ? 8 : -8;
-    Bitboard start_mask = white_to_move ? (0xFFULL << 8) : (0xFFULL << 48);
-    Bitboard promotion_rank_mask = white_to_move ? (0xFFULL << 56) : (0xFFULL << 0);
-    while (pawns_mask)
+    Bitboard empty_mask = ~board.all_pieces;
+    Bitboard enemy_pieces_mask = Us == WHITE ? board.black_pieces : board.white_pieces;
+
+    // Pushes (promotion pushes count as captures, see GenType)
+    Bitboard single_pushes = shift<up>(pawns_mask) & empty_mask;
+    serialize_pawn_moves<Us, up, false, Type>(board, moves, single_pushes & check_mask, pins);
+    if constexpr (Type != CAPTURES)
     {
+        Bitboard double_pushes = shift<up>(single_pushes & double_push_rank) & empty_mask;
+        serialize_pawn_moves<Us, 2 * up, false, Type>(board, moves, double_pushes & check_mask, pins);
+    }
+    if constexpr (Type == QUIETS)
+        return;
 
-        int source_square = __builtin_ctzll(pawns_mask);
-        int target_square = source_square + direction;
-        Bitboard allowed = check_mask & pin_masks[source_square];
+    // Captures (mask out the wrapping file before shifting)
+    Bitboard left_captures = shift<up_left>(pawns_mask & ~FILE_A) & enemy_pieces_mask;
+    Bitboard right_captures = shift<up_right>(pawns_mask & ~FILE_H) & enemy_pieces_mask;
+    serialize_pawn_moves<Us, up_left, true, Type>(board, moves, left_captures & check_mask, pins);
+    serialize_pawn_moves<Us, up_right, true, Type>(board, moves, right_captures & check_mask, pins);
 
-        if ((1ULL << target_square) & (~board.all_pieces))
+    // En passant - at most two pawns, legality verified by playing the move
+    // (covers horizontal pins where both pawns leave the king's rank)
+    if (board.enpassant_square)
+    {
+        int ep_square = __builtin_ctzll(board.enpassant_square);
+        Bitboard ep_pawns = pawns_mask & pawn_attacks[Them][ep_square];
+        while (ep_pawns)
         {
-            // if in check or pinned
-            if ((1ULL << target_square) & allowed)
-            {
-                // Promotions
-                if ((1ULL << target_square) & promotion_rank_mask)
-                {
-                    moves.emplace_back(source_square, target_square, pawn_type, 0, white_to_move ? WHITE_QUEEN : BLACK_QUEEN);
-                    moves.emplace_back(source_square, target_square, pawn_type, 0, white_to_move ? WHITE_ROOK : BLACK_ROOK);
-                    moves.emplace_back(source_square, target_square, pawn_type, 0, white_to_move ? WHITE_BISHOP : BLACK_BISHOP);
-                    moves.emplace_back(source_square, target_square, pawn_type, 0, white_to_move ? WHITE_KNIGHT : BLACK_KNIGHT);
-                }
-                else
-                    moves.emplace_back(source_square, target_square, pawn_type);
-            }
-            // Double move from starting position
-            if ((1ULL << source_square) & start_mask)
+            int source_square = __builtin_ctzll(ep_pawns);
+            Move move(source_square, ep_square, pawn_type, make_piece(Them, PAWN), 0, 1);
+            board.make_move(move);
+            if (!board.is_in_check<Us>())
             {
-                int double_move_square = source_square + 2 * direction;
-                if (((1ULL << double_move_square) & (~board.all_pieces)) && ((1ULL << double_move_square) & allowed))
-                {
-                    moves.emplace_back(source_square, double_move_square, pawn_type);
-                }
+                moves.emplace_back(move);
             }
+            board.undo_move(move);
+            ep_pawns &= ep_pawns - 1;
         }
-        // Captures
-        Bitboard pawn_attacks_mask = pawn_attacks[white_to_move ? 0 : 1][source_square];
-        Bitboard capture_targets = pawn_attacks_mask & enemy_pieces_mask;
+    }
+}
+template <Color Us, int Delta, bool Capture, GenType Type>
+void MoveGenerator::serialize_pawn_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins)
+{
+    constexpr int pawn_type = make_piece(Us, PAWN);
+    constexpr Bitboard promotion_rank_mask = Us == WHITE ? RANK_8 : RANK_1;
+
+    Bitboard promotions = Type == QUIETS ? 0 : targets & promotion_rank_mask;
+    // Plain pushes are quiet, plain captures are captures
+    targets = Type == (Capture ? QUIETS : CAPTURES) ? 0 : targets & ~promotion_rank_mask;
 
-        while (capture_targets)
+    while (targets)
+    {
+        int target_square = __builtin_ctzll(targets);
+        int source_square = target_square - Delta;
+        // if pinned, target has to stay on the pin line
+        if (pins.allows(source_square, target_square))
         {
-            int attack_square = __builtin_ctzll(capture_targets);
-            int captured_piece = board.board_arr[attack_square];
-            // if in check or pinned
-            if ((1ULL << attack_square) & allowed)
-            {
-                // Promotions on capture
-                if ((1ULL << attack_square) & promotion_rank_mask)
-                {
-                    moves.emplace_back(source_square, attack_square, pawn_type, captured_piece, white_to_move ? WHITE_QUEEN : BLACK_QUEEN);
-                    moves.emplace_back(source_square, attack_square, pawn_type, captured_piece, white_to_move ? WHITE_ROOK : BLACK_ROOK);
-                    moves.emplace_back(source_square, attack_square, pawn_type, captured_piece, white_to_move ? WHITE_BISHOP : BLACK_BISHOP);
-                    moves.emplace_back(source_square, attack_square, pawn_type, captured_piece, white_to_move ? WHITE_KNIGHT : BLACK_KNIGHT);
-                }
-                else
-                {
-                    moves.emplace_back(source_square, attack_square, pawn_type, captured_piece);
-                }
-            }
-            capture_targets &= capture_targets - 1;
+            int captured_piece = Capture ? board.board_arr[target_square] : static_cast<int>(EMPTY);
+            moves.emplace_back(source_square, target_square, pawn_type, captured_piece);
         }
-        if (board.enpassant_square)
+        targets &= targets - 1;
+    }
+    while (promotions)
+    {
+        int target_square = __builtin_ctzll(promotions);
+        int source_square = target_square - Delta;
+        if (pins.allows(source_square, target_square))
         {
-            Bitboard ep_attacks = pawn_attacks_mask & board.enpassant_square;
-            if (ep_attacks)
-            {
-                int ep_square = __builtin_ctzll(ep_attacks);
-                int captured_pawn = white_to_move ? BLACK_PAWN : WHITE_PAWN;
-                Move move(source_square, ep_square, pawn_type, captured_pawn, 0, 1);
-                board.make_move(move, false);
-                if (!board.is_in_check(white_to_move))
-                {
-                    moves.emplace_back(move);
-                }
-                board.undo_move(move, false);
-            }
+            int captured_piece = Capture ? board.board_arr[target_square] : static_cast<int>(EMPTY);
+            moves.emplace_back(source_square, target_square, pawn_type, captured_piece, make_piece(Us, QUEEN));
+            moves.emplace_back(source_square, target_square, pawn_type, captured_piece, make_piece(Us, ROOK));
+            moves.emplace_back(source_square, target_square, pawn_type, captured_piece, make_piece(Us, BISHOP));
+            moves.emplace_back(source_square, target_square, pawn_type, captured_piece, make_piece(Us, KNIGHT));
         }
-        // delete processed pawn
-        pawns_mask &= pawns_mask - 1;
+        promotions &= promotions - 1;
     }
 }
-void MoveGenerator::generate_knight_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks)
+template <Color Us>
+void MoveGenerator::generate_knight_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins)
 {
-    bool white_to_move = board.white_to_move;
-    int piece_type = white_to_move ? WHITE_KNIGHT : BLACK_KNIGHT;
-    Bitboard knights_mask = board.bitboards[piece_type];
-    Bitboard own_pieces_mask = white_to_move ? board.white_pieces : board.black_pieces;
+    constexpr int piece_type = make_piece(Us, KNIGHT);
+    // A pinned knight can never stay on its pin line
+    Bitboard knights_mask = board.bitboards[piece_type] & ~pins.pinned;
 
     while (knights_mask)
     {
         int source_square = __builtin_ctzll(knights_mask);
-        Bitboard attacks = knight_attacks[source_square] & ~own_pieces_mask;
-        attacks &= (check_mask & pin_masks[source_square]);
+        Bitboard attacks = knight_attacks[source_square] & targets;
 
         while (attacks)
         {
@@ -127,18 +152,31 @@ void MoveGenerator::generate_knight_moves(Board &board, std::vector<Move> &moves
         knights_mask &= knights_mask - 1;
     }
 }
-void MoveGenerator::generate_king_moves(Board &board, std::vector<Move> &moves)
+template <Color Us, GenType Type>
+void MoveGenerator::generate_king_moves(Board &board, MoveList &moves)
 {
-    bool white_to_move = board.white_to_move;
-    int piece_type = white_to_move ? WHITE_KING : BLACK_KING;
+    constexpr Color Them = opposite(Us);
+    constexpr int piece_type = make_piece(Us, KING);
+    // Castling constants for this side
+    constexpr int king_side_right = Us == WHITE ? 0b0001 : 0b0100;
+    constexpr int queen_side_right = Us == WHITE ? 0b0010 : 0b1000;
+    constexpr int king_sq = Us == WHITE ? e1 : e8;
+    constexpr int f_sq = Us == WHITE ? f1 : f8;
+    constexpr int g_sq = Us == WHITE ? g1 : g8;
+    constexpr int d_sq = Us == WHITE ? d1 : d8;
+    constexpr int c_sq = Us == WHITE ? c1 : c8;
+    constexpr int b_sq = Us == WHITE ? b1 : b8;
+
     Bitboard king_mask = board.bitboards[piece_type];
-    Bitboard own_pieces_mask = white_to_move ? board.white_pieces : board.black_pieces;
+    Bitboard own_pieces_mask = Us == WHITE ? board.white_pieces : board.black_pieces;
+    Bitboard enemy_pieces_mask = Us == WHITE ? board.black_pieces : board.white_pieces;
     if (!king_mask)
     {
         return;
     }
     int source_square = __builtin_ctzll(king_mask);
-    Bitboard attacks = king_attacks[source_square] & ~own_pieces_mask;
+    Bitboard targets = Type == CAPTURES ? enemy_pieces_mask : Type == QUIETS ? ~board.all_pieces : ~own_pieces_mask;
+    Bitboard attacks = king_attacks[source_square] & targets;
 
     // Temporarily remove king from all_pieces to prevent it from blocking attacks (X-Ray fix)
     Bitboard saved_all_pieces = board.all_pieces;
@@ -147,7 +185,7 @@ void MoveGenerator::generate_king_moves(Board &board, std::vector<Move> &moves)
     while (attacks)
     {
         int target_square = __builtin_ctzll(attacks);
-        if (!board.is_square_attacked(target_square, !white_to_move))
+        if (!board.is_square_attacked<Them>(target_square))
         {
             int captured_piece = board.board_arr[target_square];
             moves.emplace_back(source_square, target_square, piece_type, captured_piece);
@@ -158,97 +196,67 @@ void MoveGenerator::generate_king_moves(Board &board, std::vector<Move> &moves)
     // Restore all_pieces
     board.all_pieces = saved_all_pieces;
 
+    if constexpr (Type == CAPTURES)
+        return;
+
     // Castling
-    if (white_to_move)
+    // King Side (e -> g)
+    if ((board.castling_rights & king_side_right) &&
+        board.board_arr[f_sq] == EMPTY && board.board_arr[g_sq] == EMPTY)
     {
-        // King Side (e1 -> g1)
-        if ((board.castling_rights & 0b0001) &&
-            board.board_arr[f1] == EMPTY && board.board_arr[g1] == EMPTY)
+        if (!board.is_square_attacked<Them>(king_sq) &&
+            !board.is_square_attacked<Them>(f_sq) &&
+            !board.is_square_attacked<Them>(g_sq))
         {
-            if (!board.is_square_attacked(e1, false) &&
-                !board.is_square_attacked(f1, false) &&
-                !board.is_square_attacked(g1, false))
-            {
-                moves.emplace_back(e1, g1, WHITE_KING, 0, 0, 0, 1);
-            }
-        }
-        // Queen Side (e1 -> c1)
-        if ((board.castling_rights & 0b0010) &&
-            board.board_arr[d1] == EMPTY && board.board_arr[c1] == EMPTY && board.board_arr[b1] == EMPTY)
-        {
-            if (!board.is_square_attacked(e1, false) &&
-                !board.is_square_attacked(d1, false) &&
-                !board.is_square_attacked(c1, false))
-            {
-                moves.emplace_back(e1, c1, WHITE_KING, 0, 0, 0, 2);
-            }
+            moves.emplace_back(king_sq, g_sq, piece_type, 0, 0, 0, 1);
         }
     }
-    else
+    // Queen Side (e -> c)
+    if ((board.castling_rights & queen_side_right) &&
+        board.board_arr[d_sq] == EMPTY && board.board_arr[c_sq] == EMPTY && board.board_arr[b_sq] == EMPTY)
     {
-        // King Side (e8 -> g8)
-        if ((board.castling_rights & 0b0100) &&
-            board.board_arr[f8] == EMPTY && board.board_arr[g8] == EMPTY)
+        if (!board.is_square_attacked<Them>(king_sq) &&
+            !board.is_square_attacked<Them>(d_sq) &&
+            !board.is_square_attacked<Them>(c_sq))
         {
-            if (!board.is_square_attacked(e8, true) &&
-                !board.is_square_attacked(f8, true) &&
-                !board.is_square_attacked(g8, true))
-            {
-                moves.emplace_back(e8, g8, BLACK_KING, 0, 0, 0, 1);
-            }
-        }
-        // Queen Side (e8 -> c8)
-        if ((board.castling_rights & 0b1000) &&
-            board.board_arr[d8] == EMPTY && board.board_arr[c8] == EMPTY && board.board_arr[b8] == EMPTY)
-        {
-            if (!board.is_square_attacked(e8, true) &&
-                !board.is_square_attacked(d8, true) &&
-                !board.is_square_attacked(c8, true))
-            {
-                moves.emplace_back(e8, c8, BLACK_KING, 0, 0, 0, 2);
-            }
+            moves.emplace_back(king_sq, c_sq, piece_type, 0, 0, 0, 2);
         }
     }
 }
-// tbi magic bitboards for sliding pieces
-void MoveGenerator::generate_sliding_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks)
+template <Color Us>
+void MoveGenerator::generate_sliding_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins)
 {
-    bool white_to_move = board.white_to_move;
-    Bitboard own_pieces_mask = white_to_move ? board.white_pieces : board.black_pieces;
-
-    int piece_types[3] = {
-        white_to_move ? WHITE_BISHOP : BLACK_BISHOP,
-        white_to_move ? WHITE_ROOK : BLACK_ROOK,
-        white_to_move ? WHITE_QUEEN : BLACK_QUEEN};
-
-    for (int piece_type : piece_types)
+    generate_slider_moves<Us, BISHOP>(board, moves, targets, pins);
+    generate_slider_moves<Us, ROOK>(board, moves, targets, pins);
+    generate_slider_moves<Us, QUEEN>(board, moves, targets, pins);
+}
+template <Color Us, PieceType Pt>
+void MoveGenerator::generate_slider_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins)
+{
+    constexpr int piece_type = make_piece(Us, Pt);
+    Bitboard pieces_mask = board.bitboards[piece_type];
+    while (pieces_mask)
     {
-        Bitboard pieces_mask = board.bitboards[piece_type];
-        while (pieces_mask)
-        {
-            int source_square = __builtin_ctzll(pieces_mask);
-            Bitboard attacks = 0ULL;
+        int source_square = __builtin_ctzll(pieces_mask);
+        Bitboard attacks;
 
-            if (piece_type == WHITE_BISHOP || piece_type == BLACK_BISHOP)
-                attacks = get_bishop_attacks(source_square, board.all_pieces);
-            else if (piece_type == WHITE_ROOK || piece_type == BLACK_ROOK)
-                attacks = get_rook_attacks(source_square, board.all_pieces);
-            else // Queen
-                attacks = get_bishop_attacks(source_square, board.all_pieces) |
-                          get_rook_attacks(source_square, board.all_pieces);
+        if constexpr (Pt == BISHOP)
+            attacks = get_bishop_attacks(source_square, board.all_pieces);
+        else if constexpr (Pt == ROOK)
+            attacks = get_rook_attacks(source_square, board.all_pieces);
+        else // Queen
+            attacks = get_queen_attacks(source_square, board.all_pieces);
 
-            attacks &= ~own_pieces_mask;
-            attacks &= (check_mask & pin_masks[source_square]);
+        attacks &= targets & pins.line_of(source_square);
 
-            while (attacks)
-            {
-                int target_square = __builtin_ctzll(attacks);
-                int captured_piece = board.board_arr[target_square];
-                moves.emplace_back(source_square, target_square, piece_type, captured_piece);
-                attacks &= attacks - 1;
-            }
-            pieces_mask &= pieces_mask - 1;
+        while (attacks)
+        {
+            int target_square = __builtin_ctzll(attacks);
+            int captured_piece = board.board_arr[target_square];
+            moves.emplace_back(source_square, target_square, piece_type, captured_piece);
+            attacks &= attacks - 1;
         }
+        pieces_mask &= pieces_mask - 1;
     }
 }
 long long MoveGenerator::perft(Board &board, int depth)
@@ -257,15 +265,38 @@ long long MoveGenerator::perft(Board &board, int depth)
         return 1;
 
     long long nodes = 0;
-    std::vector<Move> moves = generate_moves(board);
+    MoveList moves;
+    generate_moves(board, moves);
     // Bulk counting
     if (depth == 1)
         return moves.size();
     for (const auto &move : moves)
     {
-        board.make_move(move, false);
+        board.make_move(move);
         nodes += perft(board, depth - 1);
-        board.undo_move(move, false);
+        board.undo_move(move);
+    }
+    return nodes;
+}
+
+long long MoveGenerator::perft_copy_make(Board &board, int depth)
+{
+    if (depth == 0)
+        return 1;
+
+    MoveList moves;
+    generate_moves(board, moves);
+    // Bulk counting
+    if (depth == 1)
+        return moves.size();
+
+    const Position saved = board.get_position();
+    long long nodes = 0;
+    for (const auto &move : moves)
+    {
+        board.make_move(move);
+        nodes += perft_copy_make(board, depth - 1);
+        board.restore_position(saved);
     }
     return nodes;
 }
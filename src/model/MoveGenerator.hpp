@@ -3,19 +3,56 @@
 
 #include "Board.hpp"
 #include "Types.hpp"
-#include <vector>
+#include "MoveList.hpp"
+
+// Which legal moves to generate. CAPTURES and QUIETS split ALL exactly:
+// CAPTURES = captures (incl. en passant) and all promotions, QUIETS = everything else (incl. castling)
+enum GenType
+{
+    ALL,
+    CAPTURES,
+    QUIETS
+};
+
+// Pinned pieces of the side to move and its king square, from Board::get_check_info
+struct Pins
+{
+    Bitboard pinned;
+    int king_square;
+
+    // Squares the piece on `square` may move to without exposing the king
+    inline Bitboard line_of(int square) const { return pinned & (1ULL << square) ? line[king_square][square] : ~0ULL; }
+    inline bool allows(int source, int target) const { return line_of(source) & (1ULL << target); }
+};
 
 class MoveGenerator
 {
 public:
-    static std::vector<Move> generate_moves(Board &board);
+    static void generate_moves(Board &board, MoveList &moves);
+    static void generate_captures(Board &board, MoveList &moves);
+    static void generate_quiets(Board &board, MoveList &moves);
     static long long perft(Board &board, int depth);
+    // Same count, restoring a saved Position instead of undo_move - for `perft compare`
+    static long long perft_copy_make(Board &board, int depth);
 
 private:
-    static void generate_pawn_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks);
-    static void generate_knight_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks);
-    static void generate_sliding_moves(Board &board, std::vector<Move> &moves, Bitboard check_mask, Bitboard *pin_masks);
-    static void generate_king_moves(Board &board, std::vector<Move> &moves);
+    // Color-specialized generators - side to move is resolved once in generate_moves
+    template <GenType Type>
+    static void generate(Board &board, MoveList &moves);
+    template <Color Us, GenType Type>
+    static void generate_moves(Board &board, MoveList &moves);
+    template <Color Us, GenType Type>
+    static void generate_pawn_moves(Board &board, MoveList &moves, Bitboard check_mask, const Pins &pins);
+    template <Color Us, int Delta, bool Capture, GenType Type>
+    static void serialize_pawn_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins);
+    template <Color Us>
+    static void generate_knight_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins);
+    template <Color Us>
+    static void generate_sliding_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins);
+    template <Color Us, PieceType Pt>
+    static void generate_slider_moves(Board &board, MoveList &moves, Bitboard targets, const Pins &pins);
+    template <Color Us, GenType Type>
+    static void generate_king_moves(Board &board, MoveList &moves);
 };
 
 #endif
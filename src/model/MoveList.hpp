@@ -0,0 +1,35 @@
+#ifndef MOVE_LIST_HPP
+#define MOVE_LIST_HPP
+
+#include "Types.hpp"
+
+// Fixed-capacity move container living on the stack - no heap allocation per node.
+// 256 is safely above the maximum number of legal moves in any chess position (218).
+struct MoveList
+{
+    static constexpr int MAX_MOVES = 256;
+
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    template <typename... Args>
+    inline void emplace_back(Args &&...args)
+    {
+        moves[count++] = Move(static_cast<Args &&>(args)...);
+    }
+    inline void push_back(const Move &move) { moves[count++] = move; }
+    inline void clear() { count = 0; }
+
+    inline int size() const { return count; }
+    inline bool empty() const { return count == 0; }
+
+    inline Move &operator[](int i) { return moves[i]; }
+    inline const Move &operator[](int i) const { return moves[i]; }
+
+    inline Move *begin() { return moves; }
+    inline Move *end() { return moves + count; }
+    inline const Move *begin() const { return moves; }
+    inline const Move *end() const { return moves + count; }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "MovePicker.hpp"
+#include "MoveGenerator.hpp"
+#include "See.hpp"
+
+namespace
+{
+    // Indexed by PieceIndex
+    constexpr int piece_values[13] = {0, 100, 320, 330, 500, 900, 0, 100, 320, 330, 500, 900, 0};
+
+    inline bool is_capture_or_promotion(const Move &move)
+    {
+        return move.captured() || move.promotion();
+    }
+}
+
+MovePicker::MovePicker(Board &board, Move hash_move, const Move *killer_moves, uint32_t quiet_seed)
+    : board(board), stage(HASH_MOVE), captures_only(false), hash_move(hash_move), quiet_seed(quiet_seed)
+{
+    killers[0] = killer_moves[0];
+    killers[1] = killer_moves[1];
+}
+
+MovePicker::MovePicker(Board &board)
+    : board(board), stage(GENERATE_CAPTURES), captures_only(true), hash_move(0, 0, 0), quiet_seed(0)
+{
+    killers[0] = killers[1] = Move(0, 0, 0);
+}
+
+void MovePicker::generate_captures()
+{
+    if (captures_generated)
+        return;
+    MoveGenerator::generate_captures(board, captures);
+    // MVV-LVA (promotions by the promoted piece)
+    for (int i = 0; i < captures.size(); i++)
+    {
+        const Move &move = captures[i];
+        capture_scores[i] = 10 * piece_values[move.captured()] + piece_values[move.promotion()] - piece_values[move.piece()] / 10;
+    }
+    captures_generated = true;
+}
+
+void MovePicker::generate_quiets()
+{
+    if (quiets_generated)
+        return;
+    MoveGenerator::generate_quiets(board, quiets);
+    if (quiet_seed)
+        for (int i = 0; i < quiets.size(); i++)
+            quiet_scores[i] = static_cast<int>(((quiets[i].data ^ quiet_seed) * 0x85EBCA6Bu) >> 25);
+    quiets_generated = true;
+}
+
+Move MovePicker::pick_best(MoveList &moves, int *scores, int i)
+{
+    int best = i;
+    for (int j = i + 1; j < moves.size(); j++)
+        if (scores[j] > scores[best])
+            best = j;
+    if (best != i)
+    {
+        Move move = moves[best];
+        moves[best] = moves[i];
+        moves[i] = move;
+        int score = scores[best];
+        scores[best] = scores[i];
+        scores[i] = score;
+    }
+    return moves[i];
+}
+
+bool MovePicker::already_returned(const Move &move) const
+{
+    return move == hash_move || move == killers[0] || move == killers[1];
+}
+
+Move MovePicker::next_move()
+{
+    switch (stage)
+    {
+    case HASH_MOVE:
+        stage = GENERATE_CAPTURES;
+        // Validated on the board - a hash cutoff costs no move generation at all
+        if (hash_move.data && board.is_pseudo_legal(hash_move) && board.is_legal(hash_move))
+            return hash_move;
+        hash_move = Move(0, 0, 0);
+        [[fallthrough]];
+
+    case GENERATE_CAPTURES:
+        generate_captures();
+        stage = CAPTURES;
+        index = 0;
+        [[fallthrough]];
+
+    case CAPTURES:
+        while (index < captures.size())
+        {
+            Move move = pick_best(captures, capture_scores, index++);
+            if (move == hash_move)
+                continue;
+            // Losing captures are tried after the quiet moves
+            if (!captures_only && !see_ge(board, move, 0))
+            {
+                bad_captures.push_back(move);
+                continue;
+            }
+            return move;
+        }
+        if (captures_only)
+        {
+            stage = DONE;
+            return Move(0, 0, 0);
+        }
+        stage = KILLERS;
+        index = 0;
+        [[fallthrough]];
+
+    case KILLERS:
+        while (index < 2)
+        {
+            Move killer = killers[index++];
+            if (!killer.data || killer == hash_move || is_capture_or_promotion(killer))
+                continue;
+            if (board.is_pseudo_legal(killer) && board.is_legal(killer))
+                return killer;
+        }
+        stage = GENERATE_QUIETS;
+        [[fallthrough]];
+
+    case GENERATE_QUIETS:
+        generate_quiets();
+        stage = QUIETS;
+        index = 0;
+        [[fallthrough]];
+
+    case QUIETS:
+        while (index < quiets.size())
+        {
+            Move move = quiet_seed ? pick_best(quiets, quiet_scores, index++) : quiets[index++];
+            if (!already_returned(move))
+                return move;
+        }
+        stage = BAD_CAPTURES;
+        index = 0;
+        [[fallthrough]];
+
+    case BAD_CAPTURES:
+        if (index < bad_captures.size())
+            return bad_captures[index++];
+        stage = DONE;
+        [[fallthrough]];
+
+    case DONE:
+        break;
+    }
+    return Move(0, 0, 0);
+}
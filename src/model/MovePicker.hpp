@@ -0,0 +1,60 @@
+#ifndef MOVE_PICKER_HPP
+#define MOVE_PICKER_HPP
+
+#include "Board.hpp"
+#include "MoveList.hpp"
+
+// Staged move ordering for the search. Categories are generated lazily, so a cutoff on the
+// hash move or an early capture never pays for generating the quiet moves.
+//   main search: hash move -> winning/equal captures (MVV-LVA, SEE >= 0) -> killers -> quiets
+//                -> losing captures
+//   quiescence:  captures (MVV-LVA) only - losing ones are pruned by the search
+// The hash move and killers come from other nodes - they are checked with Board::is_pseudo_legal
+// and Board::is_legal before being returned, without generating a move list.
+class MovePicker
+{
+public:
+    // quiet_seed != 0 shuffles the quiet moves (Lazy SMP helpers diverge this way)
+    MovePicker(Board &board, Move hash_move, const Move *killers, uint32_t quiet_seed);
+    explicit MovePicker(Board &board);
+
+    // Next legal move, Move(0, 0, 0) when all moves have been returned
+    Move next_move();
+
+private:
+    enum Stage
+    {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        CAPTURES,
+        KILLERS,
+        GENERATE_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        DONE
+    };
+
+    void generate_captures();
+    void generate_quiets();
+    // Moves the highest scored remaining move to position `index` and returns it
+    Move pick_best(MoveList &moves, int *scores, int index);
+    bool already_returned(const Move &move) const;
+
+    Board &board;
+    Stage stage;
+    bool captures_only;
+    Move hash_move;
+    Move killers[2];
+    uint32_t quiet_seed;
+
+    bool captures_generated = false;
+    bool quiets_generated = false;
+    MoveList captures;
+    MoveList quiets;
+    MoveList bad_captures;
+    int capture_scores[MoveList::MAX_MOVES];
+    int quiet_scores[MoveList::MAX_MOVES];
+    int index = 0;
+};
+
+#endif
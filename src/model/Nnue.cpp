@@ -0,0 +1,387 @@
+#include "Nnue.hpp"
+#include <algorithm>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NNUE_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t FILE_VERSION = 0x7AF32F16;
+    constexpr int PS_END = 641;         // piece-square slots per king square (slot 0 unused)
+    constexpr int WEIGHT_SCALE_BITS = 6; // hidden layer outputs are scaled by 2^6
+    constexpr int OUTPUT_SCALE = 16;     // network output units per centipawn
+    constexpr int HALF = Accumulator::HALF_DIMENSIONS;
+
+    // ---------- Kernels ----------
+    // Every backend provides the same three operations:
+    //   accumulate - out = in + sum(added rows) - sum(removed rows)   (256 x int16)
+    //   transform  - clamp both accumulator halves to [0, 127] into 512 x uint8
+    //   affine     - out[j] = bias[j] + dot(input, weights[j])        (uint8 x int8)
+
+    void accumulate_scalar(int16_t *out, const int16_t *in, const int16_t *const *added, int add_count,
+                           const int16_t *const *removed, int remove_count)
+    {
+        for (int i = 0; i < HALF; i++)
+        {
+            int16_t value = in[i];
+            for (int a = 0; a < add_count; a++)
+                value += added[a][i];
+            for (int r = 0; r < remove_count; r++)
+                value -= removed[r][i];
+            out[i] = value;
+        }
+    }
+
+    void transform_scalar(const int16_t *us, const int16_t *them, uint8_t *out)
+    {
+        for (int i = 0; i < HALF; i++)
+        {
+            out[i] = static_cast<uint8_t>(std::clamp<int>(us[i], 0, 127));
+            out[HALF + i] = static_cast<uint8_t>(std::clamp<int>(them[i], 0, 127));
+        }
+    }
+
+    void affine_scalar(const uint8_t *input, int input_size, const int8_t *weights, const int32_t *biases,
+                       int32_t *out, int output_size)
+    {
+        for (int j = 0; j < output_size; j++)
+        {
+            int32_t sum = biases[j];
+            const int8_t *row = weights + j * input_size;
+            for (int i = 0; i < input_size; i++)
+                sum += input[i] * row[i];
+            out[j] = sum;
+        }
+    }
+
+#ifdef NNUE_X86
+    __attribute__((target("sse4.1"))) void accumulate_sse41(int16_t *out, const int16_t *in, const int16_t *const *added,
+                                                            int add_count, const int16_t *const *removed, int remove_count)
+    {
+        for (int i = 0; i < HALF; i += 8)
+        {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            for (int a = 0; a < add_count; a++)
+                value = _mm_add_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i *>(added[a] + i)));
+            for (int r = 0; r < remove_count; r++)
+                value = _mm_sub_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i *>(removed[r] + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), value);
+        }
+    }
+
+    __attribute__((target("sse4.1"))) void transform_sse41(const int16_t *us, const int16_t *them, uint8_t *out)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const int16_t *halves[2] = {us, them};
+        for (int h = 0; h < 2; h++)
+        {
+            for (int i = 0; i < HALF; i += 16)
+            {
+                __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(halves[h] + i));
+                __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(halves[h] + i + 8));
+                // Signed saturation to [-128, 127], then drop the negatives
+                __m128i packed = _mm_max_epi8(_mm_packs_epi16(low, high), zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + h * HALF + i), packed);
+            }
+        }
+    }
+
+    __attribute__((target("sse4.1"))) void affine_sse41(const uint8_t *input, int input_size, const int8_t *weights,
+                                                        const int32_t *biases, int32_t *out, int output_size)
+    {
+        const __m128i ones = _mm_set1_epi16(1);
+        for (int j = 0; j < output_size; j++)
+        {
+            const int8_t *row = weights + j * input_size;
+            __m128i sum = _mm_setzero_si128();
+            for (int i = 0; i < input_size; i += 16)
+            {
+                __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+                __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+                // u8 x i8 pairs -> i16 (cannot saturate: inputs <= 127), pairs of i16 -> i32
+                __m128i product = _mm_madd_epi16(_mm_maddubs_epi16(in, w), ones);
+                sum = _mm_add_epi32(sum, product);
+            }
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+            out[j] = biases[j] + _mm_cvtsi128_si32(sum);
+        }
+    }
+
+    __attribute__((target("avx2"))) void accumulate_avx2(int16_t *out, const int16_t *in, const int16_t *const *added,
+                                                         int add_count, const int16_t *const *removed, int remove_count)
+    {
+        for (int i = 0; i < HALF; i += 16)
+        {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            for (int a = 0; a < add_count; a++)
+                value = _mm256_add_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(added[a] + i)));
+            for (int r = 0; r < remove_count; r++)
+                value = _mm256_sub_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(removed[r] + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), value);
+        }
+    }
+
+    __attribute__((target("avx2"))) void transform_avx2(const int16_t *us, const int16_t *them, uint8_t *out)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const int16_t *halves[2] = {us, them};
+        for (int h = 0; h < 2; h++)
+        {
+            for (int i = 0; i < HALF; i += 32)
+            {
+                __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(halves[h] + i));
+                __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(halves[h] + i + 16));
+                // packs works per 128-bit lane - restore the element order afterwards
+                __m256i packed = _mm256_max_epi8(_mm256_packs_epi16(low, high), zero);
+                packed = _mm256_permute4x64_epi64(packed, 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + h * HALF + i), packed);
+            }
+        }
+    }
+
+    __attribute__((target("avx2"))) void affine_avx2(const uint8_t *input, int input_size, const int8_t *weights,
+                                                     const int32_t *biases, int32_t *out, int output_size)
+    {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (int j = 0; j < output_size; j++)
+        {
+            const int8_t *row = weights + j * input_size;
+            __m256i sum = _mm256_setzero_si256();
+            for (int i = 0; i < input_size; i += 32)
+            {
+                __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+                __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+                __m256i product = _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones);
+                sum = _mm256_add_epi32(sum, product);
+            }
+            __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+            sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0x4E));
+            sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0xB1));
+            out[j] = biases[j] + _mm_cvtsi128_si32(sum128);
+        }
+    }
+#endif
+
+    // Hidden layer activation: scale down and clamp to [0, 127]
+    void clipped_relu(const int32_t *input, uint8_t *out, int size)
+    {
+        for (int i = 0; i < size; i++)
+            out[i] = static_cast<uint8_t>(std::clamp(input[i] >> WEIGHT_SCALE_BITS, 0, 127));
+    }
+
+    SimdBackend detect_backend()
+    {
+#ifdef NNUE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdBackend::AVX2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return SimdBackend::SSE41;
+#endif
+        return SimdBackend::SCALAR;
+    }
+
+    // HalfKP index of a (non-king) piece seen from one side: the board is rotated for
+    // black so that both perspectives share the same weights
+    inline int orient(Color perspective, int square)
+    {
+        return perspective == WHITE ? square : square ^ 63;
+    }
+    inline int feature_index(Color perspective, int king_square, int piece, int square)
+    {
+        bool own = is_white_piece(piece) == (perspective == WHITE);
+        int type = is_white_piece(piece) ? piece : piece - 6;
+        int piece_slot = 1 + (2 * (type - 1) + !own) * 64;
+        return orient(perspective, king_square) * PS_END + piece_slot + orient(perspective, square);
+    }
+
+    template <typename T>
+    bool read_array(std::ifstream &file, std::vector<T> &values, size_t count)
+    {
+        values.resize(count);
+        file.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+        return static_cast<bool>(file);
+    }
+    template <typename T>
+    bool read_value(std::ifstream &file, T &value)
+    {
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return static_cast<bool>(file);
+    }
+}
+
+NnueNetwork::NnueNetwork(SimdBackend backend) : backend(backend == SimdBackend::AUTO ? detect_backend() : backend)
+{
+}
+
+const char *NnueNetwork::backend_name(SimdBackend backend)
+{
+    switch (backend)
+    {
+    case SimdBackend::AVX2:
+        return "avx2";
+    case SimdBackend::SSE41:
+        return "sse4.1";
+    case SimdBackend::SCALAR:
+        return "scalar";
+    default:
+        return "auto";
+    }
+}
+
+bool NnueNetwork::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    uint32_t version, hash, description_size;
+    if (!read_value(file, version) || version != FILE_VERSION || !read_value(file, hash) ||
+        !read_value(file, description_size))
+        return false;
+    file.ignore(description_size);
+
+    // Read into a scratch copy so a bad file leaves the current network untouched
+    NnueNetwork network(backend);
+    int32_t output_bias;
+    bool ok = read_value(file, hash) &&
+              read_array(file, network.ft_biases, HALF) &&
+              read_array(file, network.ft_weights, static_cast<size_t>(INPUT_DIMENSIONS) * HALF) &&
+              read_value(file, hash) &&
+              read_array(file, network.l1_biases, L1_OUTPUTS) &&
+              read_array(file, network.l1_weights, L1_OUTPUTS * L1_INPUTS) &&
+              read_array(file, network.l2_biases, L2_OUTPUTS) &&
+              read_array(file, network.l2_weights, L2_OUTPUTS * L1_OUTPUTS) &&
+              read_value(file, output_bias) &&
+              read_array(file, network.output_weights, L2_OUTPUTS);
+    if (!ok || file.peek() != std::ifstream::traits_type::eof())
+        return false;
+
+    ft_biases = std::move(network.ft_biases);
+    ft_weights = std::move(network.ft_weights);
+    l1_biases = std::move(network.l1_biases);
+    l1_weights = std::move(network.l1_weights);
+    l2_biases = std::move(network.l2_biases);
+    l2_weights = std::move(network.l2_weights);
+    this->output_bias = output_bias;
+    output_weights = std::move(network.output_weights);
+    loaded = true;
+    return true;
+}
+
+void NnueNetwork::refresh_perspective(const Board &board, Color perspective, int16_t *values) const
+{
+    int king_square = __builtin_ctzll(board.get_bitboard(make_piece(perspective, KING)));
+    std::copy(ft_biases.begin(), ft_biases.end(), values);
+    for (int piece = WHITE_PAWN; piece <= BLACK_QUEEN; piece++)
+    {
+        if (piece == WHITE_KING)
+            continue;
+        Bitboard pieces = board.get_bitboard(piece);
+        while (pieces)
+        {
+            const int16_t *row = &ft_weights[static_cast<size_t>(feature_index(perspective, king_square, piece, __builtin_ctzll(pieces))) * HALF];
+            for (int i = 0; i < HALF; i++)
+                values[i] += row[i];
+            pieces &= pieces - 1;
+        }
+    }
+}
+
+void NnueNetwork::refresh(const Board &board, Accumulator &accumulator) const
+{
+    refresh_perspective(board, WHITE, accumulator.values[WHITE]);
+    refresh_perspective(board, BLACK, accumulator.values[BLACK]);
+}
+
+void NnueNetwork::update(const Board &board, const Accumulator &previous, Accumulator &next) const
+{
+    const DirtyPieces &dirty = board.get_dirty_pieces();
+    for (Color perspective : {WHITE, BLACK})
+    {
+        // King squares are part of every feature - a king move invalidates its own perspective
+        int own_king = make_piece(perspective, KING);
+        bool king_moved = false;
+        for (int i = 0; i < dirty.count; i++)
+            king_moved |= dirty.piece[i] == own_king;
+        if (king_moved)
+        {
+            refresh_perspective(board, perspective, next.values[perspective]);
+            continue;
+        }
+
+        int king_square = __builtin_ctzll(board.get_bitboard(own_king));
+        const int16_t *added[3];
+        const int16_t *removed[3];
+        int add_count = 0, remove_count = 0;
+        for (int i = 0; i < dirty.count; i++)
+        {
+            int piece = dirty.piece[i];
+            if (piece == WHITE_KING || piece == BLACK_KING)
+                continue;
+            if (dirty.from[i] != NO_SQUARE)
+                removed[remove_count++] = &ft_weights[static_cast<size_t>(feature_index(perspective, king_square, piece, dirty.from[i])) * HALF];
+            if (dirty.to[i] != NO_SQUARE)
+                added[add_count++] = &ft_weights[static_cast<size_t>(feature_index(perspective, king_square, piece, dirty.to[i])) * HALF];
+        }
+
+        const int16_t *in = previous.values[perspective];
+        int16_t *out = next.values[perspective];
+#ifdef NNUE_X86
+        if (backend == SimdBackend::AVX2)
+            accumulate_avx2(out, in, added, add_count, removed, remove_count);
+        else if (backend == SimdBackend::SSE41)
+            accumulate_sse41(out, in, added, add_count, removed, remove_count);
+        else
+#endif
+            accumulate_scalar(out, in, added, add_count, removed, remove_count);
+    }
+}
+
+int NnueNetwork::evaluate(const Board &board, const Accumulator &accumulator) const
+{
+    Color us = board.is_white_to_move() ? WHITE : BLACK;
+    alignas(64) uint8_t transformed[L1_INPUTS];
+    alignas(64) int32_t l1_out[L1_OUTPUTS];
+    alignas(64) uint8_t l1_activated[L1_OUTPUTS];
+    alignas(64) int32_t l2_out[L2_OUTPUTS];
+    alignas(64) uint8_t l2_activated[L2_OUTPUTS];
+    int32_t output;
+
+    // Side to move first
+    const int16_t *first = accumulator.values[us];
+    const int16_t *second = accumulator.values[opposite(us)];
+#ifdef NNUE_X86
+    if (backend == SimdBackend::AVX2)
+    {
+        transform_avx2(first, second, transformed);
+        affine_avx2(transformed, L1_INPUTS, l1_weights.data(), l1_biases.data(), l1_out, L1_OUTPUTS);
+        clipped_relu(l1_out, l1_activated, L1_OUTPUTS);
+        affine_avx2(l1_activated, L1_OUTPUTS, l2_weights.data(), l2_biases.data(), l2_out, L2_OUTPUTS);
+        clipped_relu(l2_out, l2_activated, L2_OUTPUTS);
+        affine_avx2(l2_activated, L2_OUTPUTS, output_weights.data(), &output_bias, &output, 1);
+        return output / OUTPUT_SCALE;
+    }
+    if (backend == SimdBackend::SSE41)
+    {
+        transform_sse41(first, second, transformed);
+        affine_sse41(transformed, L1_INPUTS, l1_weights.data(), l1_biases.data(), l1_out, L1_OUTPUTS);
+        clipped_relu(l1_out, l1_activated, L1_OUTPUTS);
+        affine_sse41(l1_activated, L1_OUTPUTS, l2_weights.data(), l2_biases.data(), l2_out, L2_OUTPUTS);
+        clipped_relu(l2_out, l2_activated, L2_OUTPUTS);
+        affine_sse41(l2_activated, L2_OUTPUTS, output_weights.data(), &output_bias, &output, 1);
+        return output / OUTPUT_SCALE;
+    }
+#endif
+    transform_scalar(first, second, transformed);
+    affine_scalar(transformed, L1_INPUTS, l1_weights.data(), l1_biases.data(), l1_out, L1_OUTPUTS);
+    clipped_relu(l1_out, l1_activated, L1_OUTPUTS);
+    affine_scalar(l1_activated, L1_OUTPUTS, l2_weights.data(), l2_biases.data(), l2_out, L2_OUTPUTS);
+    clipped_relu(l2_out, l2_activated, L2_OUTPUTS);
+    affine_scalar(l2_activated, L2_OUTPUTS, output_weights.data(), &output_bias, &output, 1);
+    return output / OUTPUT_SCALE;
+}
@@ -0,0 +1,69 @@
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// HalfKP feature transformer output for both perspectives, indexed [Color].
+// Kept on the search stack (one per ply) and updated from Board::get_dirty_pieces().
+struct alignas(64) Accumulator
+{
+    static constexpr int HALF_DIMENSIONS = 256;
+    int16_t values[2][HALF_DIMENSIONS];
+};
+
+// Integer kernel set used for inference - chosen at run time from the CPU features,
+// so a portable build (-DENGINE_NATIVE=OFF) still gets the SIMD kernels
+enum class SimdBackend
+{
+    AUTO,
+    SCALAR,
+    SSE41,
+    AVX2
+};
+
+// NNUE evaluator: HalfKP(64 x 641) -> 256x2 -> 32 -> 32 -> 1.
+// Reads the .nnue layout of the first public HalfKP networks (little-endian; version is
+// checked, the header hashes and description are skipped).
+class NnueNetwork
+{
+public:
+    static constexpr int INPUT_DIMENSIONS = 64 * 641;
+    static constexpr int L1_INPUTS = 2 * Accumulator::HALF_DIMENSIONS;
+    static constexpr int L1_OUTPUTS = 32;
+    static constexpr int L2_OUTPUTS = 32;
+
+    explicit NnueNetwork(SimdBackend backend = SimdBackend::AUTO);
+
+    // Returns false (and keeps the previous network) if the file is missing or malformed
+    bool load(const std::string &path);
+    bool is_loaded() const { return loaded; }
+    SimdBackend get_backend() const { return backend; }
+    static const char *backend_name(SimdBackend backend);
+
+    // Full rebuild of both perspectives from the board
+    void refresh(const Board &board, Accumulator &accumulator) const;
+    // next = previous + changes of the last make_move; a perspective whose king moved is rebuilt
+    void update(const Board &board, const Accumulator &previous, Accumulator &next) const;
+    // Score in centipawns from the side to move's point of view
+    int evaluate(const Board &board, const Accumulator &accumulator) const;
+
+private:
+    void refresh_perspective(const Board &board, Color perspective, int16_t *values) const;
+
+    SimdBackend backend;
+    bool loaded = false;
+
+    std::vector<int16_t> ft_biases;  // [256]
+    std::vector<int16_t> ft_weights; // [INPUT_DIMENSIONS][256]
+    std::vector<int32_t> l1_biases;  // [32]
+    std::vector<int8_t> l1_weights;  // [32][512]
+    std::vector<int32_t> l2_biases;  // [32]
+    std::vector<int8_t> l2_weights;  // [32][32]
+    int32_t output_bias = 0;
+    std::vector<int8_t> output_weights; // [32]
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "Notation.hpp"
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+
+std::string square_to_string(int square)
+{
+    std::string name;
+    name += static_cast<char>('a' + square % 8);
+    name += static_cast<char>('1' + square / 8);
+    return name;
+}
+
+int string_to_square(const std::string &name)
+{
+    if (name.length() < 2)
+        return -1;
+    int file = name[0] - 'a';
+    int rank = name[1] - '1';
+    if (file < 0 || file > 7 || rank < 0 || rank > 7)
+        return -1;
+    return rank * 8 + file;
+}
+
+std::string move_to_uci(const Move &move)
+{
+    std::string result = square_to_string(move.source()) + square_to_string(move.target());
+    if (move.promotion())
+    {
+        // Promotion piece letter is the same for both colors
+        static const char promotion_chars[] = " nbrq";
+        int type = move.promotion() > WHITE_KING ? move.promotion() - 6 : move.promotion();
+        result += promotion_chars[type - 1];
+    }
+    return result;
+}
+
+Move uci_to_move(Board &board, const std::string &text)
+{
+    MoveList moves;
+    MoveGenerator::generate_moves(board, moves);
+    for (const Move &move : moves)
+        if (move_to_uci(move) == text)
+            return move;
+    return Move(0, 0, 0);
+}
@@ -0,0 +1,18 @@
+#ifndef NOTATION_HPP
+#define NOTATION_HPP
+
+#include <string>
+#include "Types.hpp"
+
+class Board;
+
+// Square index (0-63) <-> algebraic name ("a1".."h8"), -1 if the name is invalid
+std::string square_to_string(int square);
+int string_to_square(const std::string &name);
+
+// Long algebraic (UCI) notation, e.g. "e2e4", "e7e8q"
+std::string move_to_uci(const Move &move);
+// Legal move of the position matching the UCI string, Move(0, 0, 0) if there is none
+Move uci_to_move(Board &board, const std::string &text);
+
+#endif
@@ -0,0 +1,199 @@
+#include "Perft.hpp"
+#include "MoveGenerator.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    // Deepest ply at which the tree is still split into tasks
+    constexpr int MAX_SPLIT_PLIES = 3;
+    // Tasks per thread to aim for - more tasks balance uneven subtrees better
+    constexpr int TASKS_PER_THREAD = 8;
+
+    struct PerftTask
+    {
+        Move moves[MAX_SPLIT_PLIES];
+        int length = 0;
+    };
+
+    // Expands every task by one ply. Tasks without legal moves are dropped,
+    // they contain no leaf nodes at the requested depth.
+    std::vector<PerftTask> split_tasks(Board &board, const std::vector<PerftTask> &tasks)
+    {
+        std::vector<PerftTask> result;
+        MoveList moves;
+        for (const PerftTask &task : tasks)
+        {
+            for (int i = 0; i < task.length; i++)
+                board.make_move(task.moves[i]);
+
+            MoveGenerator::generate_moves(board, moves);
+            for (const Move &move : moves)
+            {
+                PerftTask child = task;
+                child.moves[child.length++] = move;
+                result.push_back(child);
+            }
+
+            for (int i = task.length - 1; i >= 0; i--)
+                board.undo_move(task.moves[i]);
+        }
+        return result;
+    }
+}
+
+PerftTable::PerftTable(size_t size_mb)
+{
+    // Largest power of two number of entries that fits in size_mb
+    size_t max_entries = size_mb * 1024 * 1024 / sizeof(Entry);
+    entry_count = 1;
+    while (entry_count * 2 <= max_entries)
+        entry_count *= 2;
+    index_mask = entry_count - 1;
+    entries = std::vector<Entry>(entry_count);
+    clear();
+}
+
+void PerftTable::clear()
+{
+    for (Entry &entry : entries)
+    {
+        entry.key_xor_data.store(0, std::memory_order_relaxed);
+        entry.data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool PerftTable::probe(uint64_t key, int depth, long long &nodes) const
+{
+    const Entry &entry = entries[key & index_mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t key_xor_data = entry.key_xor_data.load(std::memory_order_relaxed);
+    if ((key_xor_data ^ data) != key || static_cast<int>(data & 0xFF) != depth)
+        return false;
+    nodes = static_cast<long long>(data >> 8);
+    return true;
+}
+
+void PerftTable::store(uint64_t key, int depth, long long nodes)
+{
+    Entry &entry = entries[key & index_mask];
+    uint64_t data = (static_cast<uint64_t>(nodes) << 8) | static_cast<uint64_t>(depth);
+    entry.key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+long long perft_hashed(Board &board, int depth, PerftTable &table, PerftThreadStats &stats)
+{
+    if (depth == 0)
+        return 1;
+
+    MoveList moves;
+    // Bulk counting - cheaper than a table probe
+    if (depth == 1)
+    {
+        MoveGenerator::generate_moves(board, moves);
+        return moves.size();
+    }
+
+    uint64_t key = board.get_zobrist_key();
+    long long nodes = 0;
+    if (table.probe(key, depth, nodes))
+    {
+        stats.hash_hits++;
+        return nodes;
+    }
+    stats.hash_misses++;
+
+    MoveGenerator::generate_moves(board, moves);
+    for (const auto &move : moves)
+    {
+        board.make_move(move);
+        nodes += perft_hashed(board, depth - 1, table, stats);
+        board.undo_move(move);
+    }
+    table.store(key, depth, nodes);
+    return nodes;
+}
+
+PerftResult perft_parallel(const Board &board, int depth, int thread_count, PerftTable *table)
+{
+    using clock = std::chrono::steady_clock;
+    PerftResult result;
+    auto start = clock::now();
+
+    if (thread_count < 1)
+        thread_count = 1;
+    if (depth <= 0)
+    {
+        result.nodes = 1;
+        result.threads.resize(1);
+        return result;
+    }
+
+    // Split at the root, then keep splitting while there are too few subtrees
+    Board root = board;
+    std::vector<PerftTask> tasks(1);
+    int split_plies = 0;
+    while (split_plies < depth - 1 && split_plies < MAX_SPLIT_PLIES &&
+           (split_plies == 0 || tasks.size() < static_cast<size_t>(thread_count * TASKS_PER_THREAD)))
+    {
+        tasks = split_tasks(root, tasks);
+        split_plies++;
+    }
+
+    // Depth 1 - the root move count is the answer
+    if (split_plies == 0)
+    {
+        MoveList moves;
+        MoveGenerator::generate_moves(root, moves);
+        result.nodes = moves.size();
+        result.threads.resize(1);
+        result.threads[0].nodes = result.nodes;
+        result.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        result.threads[0].seconds = result.seconds;
+        return result;
+    }
+
+    std::atomic<size_t> next_task{0};
+    result.threads.resize(thread_count);
+
+    auto worker = [&](PerftThreadStats &stats)
+    {
+        auto thread_start = clock::now();
+        Board local = root;
+        size_t index;
+        while ((index = next_task.fetch_add(1, std::memory_order_relaxed)) < tasks.size())
+        {
+            const PerftTask &task = tasks[index];
+            for (int i = 0; i < task.length; i++)
+                local.make_move(task.moves[i]);
+
+            if (table)
+                stats.nodes += perft_hashed(local, depth - task.length, *table, stats);
+            else
+                stats.nodes += MoveGenerator::perft(local, depth - task.length);
+            stats.tasks++;
+
+            for (int i = task.length - 1; i >= 0; i--)
+                local.undo_move(task.moves[i]);
+        }
+        stats.seconds = std::chrono::duration<double>(clock::now() - thread_start).count();
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < thread_count; i++)
+        threads.emplace_back(worker, std::ref(result.threads[i]));
+    worker(result.threads[0]);
+    for (auto &thread : threads)
+        thread.join();
+
+    for (const PerftThreadStats &stats : result.threads)
+    {
+        result.nodes += stats.nodes;
+        result.hash_hits += stats.hash_hits;
+        result.hash_misses += stats.hash_misses;
+    }
+    result.seconds = std::chrono::duration<double>(clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include "Board.hpp"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+struct PerftThreadStats
+{
+    long long nodes = 0;
+    int tasks = 0;
+    double seconds = 0.0;
+    long long hash_hits = 0;
+    long long hash_misses = 0;
+};
+
+// Fixed-size (Zobrist key, depth) -> node count cache shared by all perft threads.
+// Lock-free: every entry stores key ^ data next to data, so a torn read from a
+// concurrent write fails validation and is treated as a miss.
+class PerftTable
+{
+public:
+    explicit PerftTable(size_t size_mb);
+    PerftTable(const PerftTable &) = delete;
+    PerftTable &operator=(const PerftTable &) = delete;
+
+    bool probe(uint64_t key, int depth, long long &nodes) const;
+    void store(uint64_t key, int depth, long long nodes);
+    void clear();
+    size_t size_bytes() const { return entry_count * sizeof(Entry); }
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data; // bits 0-7 depth, bits 8-63 node count
+    };
+    std::vector<Entry> entries;
+    size_t entry_count;
+    uint64_t index_mask;
+};
+
+struct PerftResult
+{
+    long long nodes = 0;
+    double seconds = 0.0;
+    long long hash_hits = 0;
+    long long hash_misses = 0;
+    std::vector<PerftThreadStats> threads;
+};
+
+// Serial perft that caches subtree counts in table (depth >= 2 nodes only).
+long long perft_hashed(Board &board, int depth, PerftTable &table, PerftThreadStats &stats);
+
+// Parallel perft. The tree is split at the root (and at deeper plies while there are
+// too few subtrees to keep every thread busy); each worker owns its own Board copy
+// and pulls subtrees from a shared queue. Node counts are identical to MoveGenerator::perft.
+// With a table all threads share it through perft_hashed.
+PerftResult perft_parallel(const Board &board, int depth, int thread_count, PerftTable *table = nullptr);
+
+#endif
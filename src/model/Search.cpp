@@ -0,0 +1,241 @@
+#include "Search.hpp"
+#include "MoveGenerator.hpp"
+#include "MovePicker.hpp"
+#include "See.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Check time/node limits every this many nodes (must be a power of two)
+    constexpr long long CHECK_INTERVAL = 2048;
+
+    // Mate scores are stored relative to the node, not the root
+    inline int score_to_tt(int score, int ply)
+    {
+        return score >= MATE_BOUND ? score + ply : score <= -MATE_BOUND ? score - ply : score;
+    }
+    inline int score_from_tt(int score, int ply)
+    {
+        return score >= MATE_BOUND ? score - ply : score <= -MATE_BOUND ? score + ply : score;
+    }
+}
+
+Move Search::search(Board &board, const SearchLimits &search_limits, const InfoCallback &on_iteration)
+{
+    limits = search_limits;
+    if (stop_flag == &own_stop_flag)
+        own_stop_flag.store(false, std::memory_order_relaxed);
+    nodes.store(0, std::memory_order_relaxed);
+    tt_stats = TTStats();
+    start_time = std::chrono::steady_clock::now();
+    previous_pv.clear();
+    for (auto &ply_killers : killers)
+        ply_killers[0] = ply_killers[1] = Move(0, 0, 0);
+
+    MoveList root_moves;
+    MoveGenerator::generate_moves(board, root_moves);
+    if (root_moves.empty())
+        return Move(0, 0, 0);
+
+    if (network)
+        network->refresh(board, accumulators[0]);
+
+    Move best_move = root_moves[0];
+    int max_depth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+
+    // Helpers with odd ids start one ply deeper so threads are spread over two depths
+    for (int depth = 1 + (thread_id & 1); depth <= max_depth; depth++)
+    {
+        int score = negamax(board, depth, 0, -INF_SCORE, INF_SCORE);
+
+        // Interrupted iteration - keep the result of the last completed one
+        if (stop_flag->load(std::memory_order_relaxed))
+        {
+            if (depth == 1 && pv_length[0] > 0)
+                best_move = pv_table[0][0];
+            break;
+        }
+
+        previous_pv.assign(pv_table[0], pv_table[0] + pv_length[0]);
+        if (!previous_pv.empty())
+            best_move = previous_pv[0];
+
+        if (on_iteration)
+        {
+            SearchInfo info;
+            info.depth = depth;
+            info.score = score;
+            info.nodes = get_nodes();
+            info.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            info.nps = info.seconds > 0 ? static_cast<long long>(info.nodes / info.seconds) : 0;
+            info.pv = previous_pv;
+            info.hashfull = tt.hashfull();
+            info.tt_stats = tt_stats;
+            on_iteration(info);
+        }
+
+        // Forced mate found - deeper iterations cannot improve on it
+        if (std::abs(score) >= MATE_BOUND && MATE_SCORE - std::abs(score) <= depth)
+            break;
+    }
+    return best_move;
+}
+
+bool Search::should_stop()
+{
+    if (limits.nodes && (node_total ? node_total() : get_nodes()) >= limits.nodes)
+        return true;
+    if (limits.movetime_ms)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= limits.movetime_ms)
+            return true;
+    }
+    return false;
+}
+
+int Search::negamax(Board &board, int depth, int ply, int alpha, int beta)
+{
+    pv_length[ply] = 0;
+
+    // Draws: 50-move rule, threefold repetition, insufficient material
+    if (ply > 0 && (board.get_halfmove_clock() >= 100 || board.is_repetition() || board.has_insufficient_material()))
+        return 0;
+
+    bool in_check = board.in_check();
+    // Check extension - never drop into quiescence while in check
+    if (in_check)
+        depth++;
+
+    if (depth <= 0)
+        return quiescence(board, ply, alpha, beta);
+    if (ply >= MAX_PLY - 1)
+        return evaluate(board, ply);
+
+    if ((count_node() & (CHECK_INTERVAL - 1)) == 0 && should_stop())
+        stop_flag->store(true, std::memory_order_relaxed);
+    if (stop_flag->load(std::memory_order_relaxed))
+        return 0;
+
+    // Transposition table - cutoff on a deep enough entry, otherwise use its move for ordering
+    uint64_t key = board.get_zobrist_key();
+    TTEntry tt_entry;
+    Move tt_move(0, 0, 0);
+    if (tt.probe(key, tt_entry, tt_stats))
+    {
+        tt_move = tt_entry.move;
+        if (ply > 0 && tt_entry.depth >= depth)
+        {
+            int tt_score = score_from_tt(tt_entry.score, ply);
+            if (tt_entry.bound == BOUND_EXACT ||
+                (tt_entry.bound == BOUND_LOWER && tt_score >= beta) ||
+                (tt_entry.bound == BOUND_UPPER && tt_score <= alpha))
+                return tt_score;
+        }
+    }
+
+    Move pv_move = ply < static_cast<int>(previous_pv.size()) ? previous_pv[ply] : Move(0, 0, 0);
+    // Helpers (Lazy SMP) shuffle their quiet moves so threads explore different subtrees first
+    MovePicker picker(board, tt_move.data ? tt_move : pv_move, killers[ply], thread_id * 0x9E3779B9u);
+
+    // Copy-make - restoring the saved position beats undo_move here (perft keeps make/undo)
+    const Position saved = board.get_position();
+    int original_alpha = alpha;
+    int move_count = 0;
+    Move best_move(0, 0, 0);
+    for (Move move = picker.next_move(); move.data; move = picker.next_move())
+    {
+        move_count++;
+        board.make_move(move);
+        tt.prefetch(board.get_zobrist_key());
+        update_accumulator(board, ply);
+        int score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+        board.restore_position(saved);
+
+        if (stop_flag->load(std::memory_order_relaxed))
+            return 0;
+
+        if (score > alpha)
+        {
+            alpha = score;
+            best_move = move;
+            // Update principal variation
+            pv_table[ply][0] = move;
+            for (int i = 0; i < pv_length[ply + 1]; i++)
+                pv_table[ply][i + 1] = pv_table[ply + 1][i];
+            pv_length[ply] = pv_length[ply + 1] + 1;
+
+            if (alpha >= beta)
+            {
+                // Quiet move that refuted this node - try it early in sibling nodes
+                if (!move.captured() && !move.promotion() && move != killers[ply][0])
+                {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = move;
+                }
+                tt.store(key, depth, score_to_tt(beta, ply), BOUND_LOWER, move, tt_stats);
+                return beta;
+            }
+        }
+    }
+
+    // Checkmate / stalemate (prefer shorter mates)
+    if (move_count == 0)
+        return in_check ? -MATE_SCORE + ply : 0;
+
+    tt.store(key, depth, score_to_tt(alpha, ply), alpha > original_alpha ? BOUND_EXACT : BOUND_UPPER, best_move, tt_stats);
+    return alpha;
+}
+
+int Search::quiescence(Board &board, int ply, int alpha, int beta)
+{
+    pv_length[ply] = 0;
+
+    if ((count_node() & (CHECK_INTERVAL - 1)) == 0 && should_stop())
+        stop_flag->store(true, std::memory_order_relaxed);
+    if (stop_flag->load(std::memory_order_relaxed))
+        return 0;
+
+    int stand_pat = evaluate(board, ply);
+    if (ply >= MAX_PLY - 1)
+        return stand_pat;
+    if (stand_pat >= beta)
+        return beta;
+    if (stand_pat > alpha)
+        alpha = stand_pat;
+
+    // Only captures and promotions
+    MovePicker picker(board);
+    const Position saved = board.get_position();
+    for (Move move = picker.next_move(); move.data; move = picker.next_move())
+    {
+        // Captures that lose material cannot raise the stand-pat score
+        if (!see_ge(board, move, 0))
+            continue;
+
+        board.make_move(move);
+        update_accumulator(board, ply);
+        int score = -quiescence(board, ply + 1, -beta, -alpha);
+        board.restore_position(saved);
+
+        if (stop_flag->load(std::memory_order_relaxed))
+            return 0;
+
+        if (score > alpha)
+        {
+            alpha = score;
+            if (alpha >= beta)
+                return beta;
+        }
+    }
+    return alpha;
+}
+
+// From the side to move's point of view
+int Search::evaluate(const Board &board, int ply) const
+{
+    // Network output is unbounded - keep it out of the mate score range
+    if (network)
+        return std::clamp(network->evaluate(board, accumulators[ply]), -MATE_BOUND + 1, MATE_BOUND - 1);
+    return board.evaluate();
+}
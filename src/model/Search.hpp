@@ -0,0 +1,112 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include "Board.hpp"
+#include "MoveList.hpp"
+#include "Nnue.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
+
+constexpr int MAX_PLY = 128;
+constexpr int INF_SCORE = 32001;
+constexpr int MATE_SCORE = 32000;
+// Scores beyond this bound are mate scores (MATE_SCORE - plies to mate)
+constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+
+// 0 means "no limit"
+struct SearchLimits
+{
+    int depth = 0;
+    long long nodes = 0;
+    int movetime_ms = 0;
+};
+
+// Reported after every completed iteration
+struct SearchInfo
+{
+    int depth = 0;
+    int score = 0; // centipawns from side to move, or +/-(MATE_SCORE - ply)
+    long long nodes = 0;
+    double seconds = 0.0;
+    long long nps = 0;
+    std::vector<Move> pv;
+    int hashfull = 0; // permille
+    TTStats tt_stats;
+};
+
+// Negamax alpha-beta with iterative deepening and quiescence search.
+// Call TranspositionTable::new_search() before every search (once, also with several threads).
+class Search
+{
+public:
+    using InfoCallback = std::function<void(const SearchInfo &)>;
+
+    explicit Search(TranspositionTable &table, int thread_id = 0) : tt(table), thread_id(thread_id) {}
+
+    // Returns the best move of the last completed iteration (Move(0, 0, 0) if no legal move)
+    Move search(Board &board, const SearchLimits &limits, const InfoCallback &on_iteration = nullptr);
+    // Safe to call from another thread while search() runs
+    void stop() { stop_flag->store(true, std::memory_order_relaxed); }
+    // Lazy SMP: all threads of one search watch the same flag. A shared flag is not
+    // reset by search() - its owner clears it before starting the threads.
+    void share_stop_flag(std::atomic<bool> *flag) { stop_flag = flag ? flag : &own_stop_flag; }
+    // Lazy SMP: the node limit is checked against this total (all threads) instead of own nodes
+    void share_node_total(std::function<long long()> total) { node_total = std::move(total); }
+    // Safe to read from another thread while search() runs
+    long long get_nodes() const { return nodes.load(std::memory_order_relaxed); }
+    // Only while search() is not running
+    void reset_nodes() { nodes.store(0, std::memory_order_relaxed); }
+    const TTStats &get_tt_stats() const { return tt_stats; }
+    // NNUE evaluation when set (and loaded), the incremental material + PST score otherwise.
+    // The network must not be reloaded while a search runs.
+    void set_network(const NnueNetwork *nnue) { network = nnue && nnue->is_loaded() ? nnue : nullptr; }
+
+private:
+    int negamax(Board &board, int depth, int ply, int alpha, int beta);
+    int quiescence(Board &board, int ply, int alpha, int beta);
+    int evaluate(const Board &board, int ply) const;
+    // Call right after make_move at `ply` - brings the child's accumulator up to date
+    inline void update_accumulator(const Board &board, int ply)
+    {
+        if (network)
+            network->update(board, accumulators[ply], accumulators[ply + 1]);
+    }
+    bool should_stop();
+    // Single writer - plain load/store instead of a locked increment
+    inline long long count_node()
+    {
+        long long count = nodes.load(std::memory_order_relaxed) + 1;
+        nodes.store(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    TranspositionTable &tt;
+    TTStats tt_stats;
+    // 0 = main thread; helpers (Lazy SMP) vary iteration depths and quiet move order
+    int thread_id;
+
+    std::atomic<bool> own_stop_flag{false};
+    std::atomic<bool> *stop_flag = &own_stop_flag;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start_time;
+    std::atomic<long long> nodes{0};
+    std::function<long long()> node_total;
+
+    const NnueNetwork *network = nullptr;
+    // One accumulator per ply, [0] = root
+    Accumulator accumulators[MAX_PLY];
+
+    // Two most recent quiet moves that caused a beta cutoff, per ply
+    Move killers[MAX_PLY][2];
+
+    // Triangular principal variation table
+    Move pv_table[MAX_PLY][MAX_PLY];
+    int pv_length[MAX_PLY];
+    std::vector<Move> previous_pv;
+};
+
+#endif
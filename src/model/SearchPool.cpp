@@ -0,0 +1,137 @@
+#include "SearchPool.hpp"
+#include <algorithm>
+
+SearchPool::SearchPool(TranspositionTable &table, int thread_count) : tt(table)
+{
+    set_threads(thread_count);
+}
+
+SearchPool::~SearchPool()
+{
+    stop_helpers();
+}
+
+void SearchPool::set_threads(int thread_count)
+{
+    thread_count = std::max(1, thread_count);
+    stop_helpers();
+
+    searches.clear();
+    boards.clear();
+    for (int i = 0; i < thread_count; i++)
+    {
+        searches.push_back(std::make_unique<Search>(tt, i));
+        searches.back()->share_stop_flag(&stop_flag);
+        searches.back()->set_network(network);
+        boards.push_back(nullptr);
+    }
+    // go nodes N limits the whole pool, not every thread
+    searches[0]->share_node_total([this]
+                                  { return get_nodes(); });
+    start_helpers(thread_count - 1);
+}
+
+void SearchPool::set_network(const NnueNetwork *nnue)
+{
+    network = nnue;
+    for (auto &search : searches)
+        search->set_network(nnue);
+}
+
+void SearchPool::start_helpers(int helper_count)
+{
+    quit = false;
+    for (int i = 1; i <= helper_count; i++)
+        threads.emplace_back(&SearchPool::helper_loop, this, i, job_id);
+}
+
+void SearchPool::stop_helpers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    start_cv.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+// Starts idle - waits for the first job after last_job (the job id when the thread was created)
+void SearchPool::helper_loop(int index, uint64_t last_job)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&]
+                          { return quit || job_id != last_job; });
+            if (quit)
+                return;
+            last_job = job_id;
+        }
+
+        searches[index]->search(*boards[index], helper_limits);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+        }
+        done_cv.notify_all();
+    }
+}
+
+Move SearchPool::search(const Board &board, const SearchLimits &limits, const Search::InfoCallback &on_iteration)
+{
+    tt.new_search();
+    stop_flag.store(false, std::memory_order_relaxed);
+
+    // Helpers run until the main thread stops them - only the depth limit applies to them
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 1; i < searches.size(); i++)
+        {
+            boards[i] = std::make_unique<Board>(board);
+            // Before the helpers start - the main thread's first total must not see the last search
+            searches[i]->reset_nodes();
+        }
+        helper_limits = SearchLimits();
+        helper_limits.depth = limits.depth;
+        running = static_cast<int>(searches.size()) - 1;
+        job_id++;
+    }
+    start_cv.notify_all();
+
+    Board main_board = board;
+    Move best_move = searches[0]->search(main_board, limits, [&](const SearchInfo &info)
+                                         {
+        if (!on_iteration)
+            return;
+        SearchInfo total = info;
+        total.nodes = get_nodes();
+        total.nps = info.seconds > 0 ? static_cast<long long>(total.nodes / info.seconds) : 0;
+        on_iteration(total); });
+
+    // Main thread done - stop helpers and wait until all of them are idle again
+    stop_flag.store(true, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [&]
+                 { return running == 0; });
+    return best_move;
+}
+
+long long SearchPool::get_nodes() const
+{
+    long long total = 0;
+    for (const auto &search : searches)
+        total += search->get_nodes();
+    return total;
+}
+
+std::vector<long long> SearchPool::get_thread_nodes() const
+{
+    std::vector<long long> result;
+    for (const auto &search : searches)
+        result.push_back(search->get_nodes());
+    return result;
+}
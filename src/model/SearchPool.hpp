@@ -0,0 +1,60 @@
+#ifndef SEARCH_POOL_HPP
+#define SEARCH_POOL_HPP
+
+#include "Search.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Lazy SMP: the calling thread runs the main search, persistent helper threads search
+// the same position on their own Board copies and share only the transposition table.
+// Helpers differ in iteration depths and quiet move order; the main thread's result is used.
+class SearchPool
+{
+public:
+    explicit SearchPool(TranspositionTable &table, int thread_count = 1);
+    ~SearchPool();
+    SearchPool(const SearchPool &) = delete;
+    SearchPool &operator=(const SearchPool &) = delete;
+
+    // Must not be called while a search is running
+    void set_threads(int thread_count);
+    int get_threads() const { return static_cast<int>(searches.size()); }
+    // Shared by all threads; null (or a network that is not loaded) selects the classical evaluation
+    void set_network(const NnueNetwork *nnue);
+
+    // Blocks until the main search finishes (limits or stop()) and all helpers have stopped.
+    // The callback receives node counts and NPS summed over all threads; limits.nodes also
+    // applies to the sum.
+    Move search(const Board &board, const SearchLimits &limits, const Search::InfoCallback &on_iteration = nullptr);
+    // Safe to call from any thread
+    void stop() { stop_flag.store(true, std::memory_order_relaxed); }
+
+    long long get_nodes() const;
+    std::vector<long long> get_thread_nodes() const;
+
+private:
+    void start_helpers(int helper_count);
+    void stop_helpers();
+    void helper_loop(int index, uint64_t last_job);
+
+    TranspositionTable &tt;
+    const NnueNetwork *network = nullptr;
+    std::atomic<bool> stop_flag{false};
+    std::vector<std::unique_ptr<Search>> searches; // [0] = main thread
+    std::vector<std::unique_ptr<Board>> boards;    // helper board copies, [0] unused
+    std::vector<std::thread> threads;              // helper i runs on threads[i - 1]
+
+    // Start/stop protocol
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    uint64_t job_id = 0;
+    int running = 0;
+    bool quit = false;
+    SearchLimits helper_limits;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "See.hpp"
+#include <algorithm>
+
+const int see_values[13] = {0, 100, 320, 330, 500, 900, 20000, 100, 320, 330, 500, 900, 20000};
+
+namespace
+{
+    // Both colors' pieces attacking `square` with the given occupancy
+    inline Bitboard attackers_to(const Board &board, int square, Bitboard occupied)
+    {
+        Bitboard bishops_queens = board.get_bitboard(WHITE_BISHOP) | board.get_bitboard(BLACK_BISHOP) |
+                                  board.get_bitboard(WHITE_QUEEN) | board.get_bitboard(BLACK_QUEEN);
+        Bitboard rooks_queens = board.get_bitboard(WHITE_ROOK) | board.get_bitboard(BLACK_ROOK) |
+                                board.get_bitboard(WHITE_QUEEN) | board.get_bitboard(BLACK_QUEEN);
+        return (pawn_attacks[BLACK][square] & board.get_bitboard(WHITE_PAWN)) |
+               (pawn_attacks[WHITE][square] & board.get_bitboard(BLACK_PAWN)) |
+               (knight_attacks[square] & (board.get_bitboard(WHITE_KNIGHT) | board.get_bitboard(BLACK_KNIGHT))) |
+               (king_attacks[square] & (board.get_bitboard(WHITE_KING) | board.get_bitboard(BLACK_KING))) |
+               (get_bishop_attacks(square, occupied) & bishops_queens) |
+               (get_rook_attacks(square, occupied) & rooks_queens);
+    }
+
+    inline bool is_king(int piece)
+    {
+        return piece == WHITE_KING || piece == BLACK_KING;
+    }
+
+    // Exchange on the target square after the move itself has been played
+    struct Exchange
+    {
+        const Board &board;
+        int square;
+        Bitboard occupied;
+        Bitboard attackers;
+        Bitboard allowed[2]; // [Color] pieces free to capture on the square - pinned ones only along their pin line
+        Color side;          // side to recapture next
+
+        Exchange(Board &board, const Move &move) : board(board), square(move.target())
+        {
+            const CheckInfo &info = board.get_check_info();
+            for (Color color : {WHITE, BLACK})
+            {
+                int king_square = __builtin_ctzll(board.get_bitboard(make_piece(color, KING)));
+                allowed[color] = ~info.pinned[color] | line[king_square][square];
+            }
+            // The moved piece now stands on the target square
+            occupied = (board.get_occupancy() ^ (1ULL << move.source())) | (1ULL << square);
+            if (move.enpassant())
+                occupied ^= 1ULL << (is_white_piece(move.piece()) ? square - 8 : square + 8);
+            attackers = attackers_to(board, square, occupied) & occupied;
+            side = is_white_piece(move.piece()) ? BLACK : WHITE;
+        }
+
+        // Removes the least valuable attacker of `side` from the board and returns its piece
+        // index (EMPTY if there is none). Uncovered sliders are added to the attackers.
+        int pop_least_valuable()
+        {
+            Bitboard own = attackers & board.get_pieces(side) & allowed[side];
+            if (!own)
+                return EMPTY;
+            for (int type = PAWN; type <= KING; type++)
+            {
+                int piece = make_piece(side, static_cast<PieceType>(type));
+                Bitboard candidates = own & board.get_bitboard(piece);
+                if (!candidates)
+                    continue;
+                occupied ^= candidates & -candidates;
+                // X-rays: only pieces on a line through the vacated square can be uncovered
+                if (type == PAWN || type == BISHOP || type == QUEEN)
+                    attackers |= get_bishop_attacks(square, occupied) &
+                                 (board.get_bitboard(WHITE_BISHOP) | board.get_bitboard(BLACK_BISHOP) |
+                                  board.get_bitboard(WHITE_QUEEN) | board.get_bitboard(BLACK_QUEEN));
+                if (type == ROOK || type == QUEEN)
+                    attackers |= get_rook_attacks(square, occupied) &
+                                 (board.get_bitboard(WHITE_ROOK) | board.get_bitboard(BLACK_ROOK) |
+                                  board.get_bitboard(WHITE_QUEEN) | board.get_bitboard(BLACK_QUEEN));
+                attackers &= occupied;
+                return piece;
+            }
+            return EMPTY;
+        }
+
+        // A king may only capture when the opponent has no attacker left
+        bool opponent_defends() const { return attackers & board.get_pieces(opposite(side)); }
+    };
+
+    // Material won by the move itself and the value of the piece left on the target square
+    inline int initial_gain(const Move &move)
+    {
+        int gain = see_values[move.enpassant() ? WHITE_PAWN : move.captured()];
+        if (move.promotion())
+            gain += see_values[move.promotion()] - see_values[WHITE_PAWN];
+        return gain;
+    }
+    inline int piece_on_target(const Move &move)
+    {
+        return see_values[move.promotion() ? move.promotion() : move.piece()];
+    }
+}
+
+int see(Board &board, const Move &move)
+{
+    if (move.castle())
+        return 0;
+
+    // Swap list: gain[d] = balance for the side making capture d if the sequence stopped there
+    int gain[32];
+    int depth = 0;
+    gain[0] = initial_gain(move);
+    int victim = piece_on_target(move);
+
+    Exchange exchange(board, move);
+    while (depth < 31)
+    {
+        int piece = exchange.pop_least_valuable();
+        if (piece == EMPTY || (is_king(piece) && exchange.opponent_defends()))
+            break;
+        depth++;
+        gain[depth] = victim - gain[depth - 1];
+        victim = see_values[piece];
+        exchange.side = opposite(exchange.side);
+    }
+
+    // Each side stops capturing when continuing would lose more
+    while (depth > 0)
+    {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
+bool see_ge(Board &board, const Move &move, int threshold)
+{
+    if (move.castle())
+        return threshold <= 0;
+
+    // Fails even if the moved piece is not recaptured
+    int swap = initial_gain(move) - threshold;
+    if (swap < 0)
+        return false;
+    // Passes even if the moved piece is lost for nothing
+    swap = piece_on_target(move) - swap;
+    if (swap <= 0)
+        return true;
+
+    // result: whether the threshold is met if the side that captured last may stop here;
+    // swap: what that side still has to win back
+    bool result = true;
+    Exchange exchange(board, move);
+    while (true)
+    {
+        int piece = exchange.pop_least_valuable();
+        if (piece == EMPTY)
+            break;
+        result = !result;
+        if (is_king(piece))
+            return exchange.opponent_defends() ? !result : result;
+        swap = see_values[piece] - swap;
+        if (swap < static_cast<int>(result))
+            break;
+        exchange.side = opposite(exchange.side);
+    }
+    return result;
+}
@@ -0,0 +1,20 @@
+#ifndef SEE_HPP
+#define SEE_HPP
+
+#include "Board.hpp"
+
+// Static exchange evaluation: material balance of the capture sequence on the move's target
+// square, both sides always recapturing with their least valuable attacker and allowed to stop.
+// Sliders behind a capturing piece join through magic lookups on the reduced occupancy (x-rays).
+// Pieces pinned to their king (Board::get_check_info) only recapture along the pin line, even
+// once the pinner has been exchanged; a king only recaptures if the square is no longer defended.
+
+// Piece values used by the exchange, indexed by PieceIndex
+extern const int see_values[13];
+
+// Exchange value in centipawns from the moving side's point of view
+int see(Board &board, const Move &move);
+// see(board, move) >= threshold, usually without resolving the whole sequence
+bool see_ge(Board &board, const Move &move, int threshold);
+
+#endif
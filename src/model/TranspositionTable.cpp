@@ -0,0 +1,153 @@
+#include "TranspositionTable.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    // Allocations of at least this size are aligned for transparent huge pages
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    inline uint64_t pack(Move move, int score, int depth, Bound bound, uint8_t age)
+    {
+        return static_cast<uint64_t>(move.data) |
+               (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32) |
+               (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48) |
+               (static_cast<uint64_t>(bound) << 56) |
+               (static_cast<uint64_t>(age) << 58);
+    }
+    inline int unpack_depth(uint64_t data) { return static_cast<int>((data >> 48) & 0xFF); }
+    inline uint8_t unpack_age(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+}
+
+TranspositionTable::TranspositionTable(size_t size_mb)
+{
+    allocate(size_mb);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+    release();
+}
+
+void TranspositionTable::resize(size_t size_mb)
+{
+    release();
+    allocate(size_mb);
+}
+
+void TranspositionTable::allocate(size_t size_mb)
+{
+    size_t bytes = (size_mb ? size_mb : 1) * 1024 * 1024;
+    size_t alignment = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(Bucket);
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+
+    buckets = static_cast<Bucket *>(std::aligned_alloc(alignment, bytes));
+    if (!buckets)
+        throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    if (alignment == HUGE_PAGE_SIZE)
+        madvise(buckets, bytes, MADV_HUGEPAGE);
+#endif
+    bucket_count = bytes / sizeof(Bucket);
+    for (size_t i = 0; i < bucket_count; i++)
+        new (&buckets[i]) Bucket;
+    clear();
+}
+
+void TranspositionTable::release()
+{
+    std::free(buckets);
+    buckets = nullptr;
+    bucket_count = 0;
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < bucket_count; i++)
+    {
+        for (Entry &entry : buckets[i].entries)
+        {
+            entry.key_xor_data.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &result, TTStats &stats) const
+{
+    stats.probes++;
+    const Bucket &bucket = buckets[bucket_index(key)];
+    for (const Entry &entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.key_xor_data.load(std::memory_order_relaxed) ^ data) != key || data == 0)
+            continue;
+
+        result.move.data = static_cast<uint32_t>(data);
+        result.score = static_cast<int16_t>(static_cast<uint16_t>(data >> 32));
+        result.depth = unpack_depth(data);
+        result.bound = static_cast<Bound>((data >> 56) & 0x3);
+        stats.hits++;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, Move move, TTStats &stats)
+{
+    Bucket &bucket = buckets[bucket_index(key)];
+    Entry *victim = nullptr;
+    int victim_value = 0;
+
+    for (Entry &entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        // Same position - overwrite, keeping the old move if the new one is empty
+        if ((entry.key_xor_data.load(std::memory_order_relaxed) ^ data) == key && data != 0)
+        {
+            if (move.data == 0)
+                move.data = static_cast<uint32_t>(data);
+            victim = &entry;
+            break;
+        }
+        // Otherwise replace the entry that is shallowest once older searches are penalized
+        int age_distance = (generation - unpack_age(data)) & AGE_MASK;
+        int value = data == 0 ? -1000 : unpack_depth(data) - 8 * age_distance;
+        if (!victim || value < victim_value)
+        {
+            victim = &entry;
+            victim_value = value;
+        }
+    }
+
+    uint64_t victim_data = victim->data.load(std::memory_order_relaxed);
+    if (victim_data != 0 && unpack_age(victim_data) == generation &&
+        (victim->key_xor_data.load(std::memory_order_relaxed) ^ victim_data) != key)
+        stats.collisions++;
+
+    uint64_t data = pack(move, score, depth, bound, generation);
+    victim->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+    stats.stores++;
+}
+
+int TranspositionTable::hashfull() const
+{
+    int used = 0;
+    int sampled = 0;
+    for (size_t i = 0; i < bucket_count && sampled < 1000; i++)
+    {
+        for (const Entry &entry : buckets[i].entries)
+        {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            used += data != 0 && unpack_age(data) == generation;
+            sampled++;
+        }
+    }
+    return sampled ? used * 1000 / sampled : 0;
+}
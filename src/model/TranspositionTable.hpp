@@ -0,0 +1,94 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include "Types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum Bound : uint8_t
+{
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1, // fail-low, score <= real value
+    BOUND_LOWER = 2, // fail-high, score >= real value
+    BOUND_EXACT = 3
+};
+
+// Decoded entry returned by probe()
+struct TTEntry
+{
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Per-thread counters - kept outside the table so threads never share a counter cache line
+struct TTStats
+{
+    long long probes = 0;
+    long long hits = 0;
+    long long stores = 0;
+    long long collisions = 0; // live entry of another position overwritten by a store
+
+    double hit_rate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+};
+
+// Shared search transposition table keyed by Board::current_zobrist_key.
+// 64-byte buckets of 4 entries; each entry stores key ^ data next to data so a read
+// racing with a write fails validation instead of returning mixed data (lockless, no mutex).
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t size_mb = 16);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    void resize(size_t size_mb);
+    void clear();
+    // Call once per search - older entries become preferred replacement victims
+    void new_search() { generation = (generation + 1) & AGE_MASK; }
+
+    bool probe(uint64_t key, TTEntry &entry, TTStats &stats) const;
+    void store(uint64_t key, int depth, int score, Bound bound, Move move, TTStats &stats);
+
+    // Hook issued right after make_move produced the child key - hides the memory latency
+    // of the bucket load behind the rest of the node setup
+    inline void prefetch(uint64_t key) const { __builtin_prefetch(&buckets[bucket_index(key)]); }
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+    size_t size_bytes() const { return bucket_count * sizeof(Bucket); }
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+    static constexpr uint8_t AGE_MASK = 0x3F;
+
+    // data layout: bits 0-31 move, 32-47 score, 48-55 depth, 56-57 bound, 58-63 age
+    struct Entry
+    {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data;
+    };
+    struct alignas(64) Bucket
+    {
+        Entry entries[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Bucket) == 64, "Bucket must fill exactly one cache line");
+
+    // Maps the key onto [0, bucket_count) without requiring a power-of-two size
+    inline size_t bucket_index(uint64_t key) const
+    {
+        __extension__ typedef unsigned __int128 uint128;
+        return static_cast<size_t>((static_cast<uint128>(key) * bucket_count) >> 64);
+    }
+    void allocate(size_t size_mb);
+    void release();
+
+    Bucket *buckets = nullptr;
+    size_t bucket_count = 0;
+    uint8_t generation = 0;
+};
+
+#endif
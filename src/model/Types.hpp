@@ -22,6 +22,33 @@ enum PieceIndex
     BLACK_QUEEN = 11,
     BLACK_KING = 12
 };
+enum Color
+{
+    WHITE = 0,
+    BLACK = 1
+};
+
+// Piece type without color - WHITE_X == X, BLACK_X == X + 6
+enum PieceType
+{
+    PAWN = 1,
+    KNIGHT = 2,
+    BISHOP = 3,
+    ROOK = 4,
+    QUEEN = 5,
+    KING = 6
+};
+
+constexpr Color opposite(Color color)
+{
+    return color == WHITE ? BLACK : WHITE;
+}
+
+constexpr int make_piece(Color color, PieceType type)
+{
+    return color == WHITE ? type : type + 6;
+}
+
 inline bool
 is_white_piece(int piece)
 {
@@ -33,6 +60,24 @@ inline bool is_black_piece(int piece)
     return piece >= BLACK_PAWN && piece <= BLACK_KING;
 }
 
+// File and rank masks
+constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H = FILE_A << 7;
+constexpr Bitboard RANK_1 = 0xFFULL;
+constexpr Bitboard RANK_3 = RANK_1 << 16;
+constexpr Bitboard RANK_6 = RANK_1 << 40;
+constexpr Bitboard RANK_8 = RANK_1 << 56;
+
+// Shift whole bitboard by a square delta (positive = towards h8)
+template <int Delta>
+constexpr Bitboard shift(Bitboard b)
+{
+    if constexpr (Delta > 0)
+        return b << Delta;
+    else
+        return b >> -Delta;
+}
+
 // clang-format off
     enum Square {
     a1, b1, c1, d1, e1, f1, g1, h1, 
@@ -46,29 +91,77 @@ inline bool is_black_piece(int piece)
     // clang-format on
 };
 
+// Packed 32-bit move:
+// bits  0-5  source square
+// bits  6-11 target square
+// bits 12-15 moving piece
+// bits 16-19 captured piece (0 if none)
+// bits 20-23 promotion piece (0 if no promotion)
+// bit  24    enpassant flag
+// bits 25-26 castle (0 none, 1 king side, 2 queen side)
 struct Move
 {
-    int source;
-    int target;
-    int piece;
-    int captured;
-    int promotion; // 0 if no promotion
-    int enpassant; // 0 if not an enpassant move
-    int castle;    // 0 if not a castling move 1 if king side, 2 if queen side
+    uint32_t data;
 
-    Move() : source(0), target(0), piece(0), captured(0), promotion(0), enpassant(0), castle(0) {}
+    // Trivial so that MoveList storage is not zero-filled on every generation call
+    Move() = default;
 
     // Constructor for standard moves
     Move(int src, int tgt, int p, int cap = 0, int prom = 0, int ep = 0, int cas = 0)
-        : source(src), target(tgt), piece(p), captured(cap), promotion(prom), enpassant(ep), castle(cas) {}
+        : data(static_cast<uint32_t>(src) | (static_cast<uint32_t>(tgt) << 6) |
+               (static_cast<uint32_t>(p) << 12) | (static_cast<uint32_t>(cap) << 16) |
+               (static_cast<uint32_t>(prom) << 20) | (static_cast<uint32_t>(ep != 0) << 24) |
+               (static_cast<uint32_t>(cas) << 25)) {}
+
+    inline int source() const { return data & 0x3F; }
+    inline int target() const { return (data >> 6) & 0x3F; }
+    inline int piece() const { return (data >> 12) & 0xF; }
+    inline int captured() const { return (data >> 16) & 0xF; }
+    inline int promotion() const { return (data >> 20) & 0xF; }
+    inline int enpassant() const { return (data >> 24) & 0x1; }
+    inline int castle() const { return (data >> 25) & 0x3; }
+
+    inline bool operator==(const Move &other) const { return data == other.data; }
+    inline bool operator!=(const Move &other) const { return data != other.data; }
+};
+static_assert(sizeof(Move) == 4, "Move must stay packed into 32 bits");
+// Piece changes made by the last make_move, replayed by incremental NNUE updates.
+// from == NO_SQUARE: piece added (promotion), to == NO_SQUARE: piece removed (capture).
+constexpr int NO_SQUARE = 64;
+struct DirtyPieces
+{
+    int count = 0;
+    int piece[3];
+    int from[3];
+    int to[3];
+
+    inline void add(int p, int f, int t)
+    {
+        piece[count] = p;
+        from[count] = f;
+        to[count] = t;
+        count++;
+    }
+};
+
+// Incrementally updated evaluation terms (white's point of view)
+struct EvalTerms
+{
+    int mg = 0;    // middlegame material + piece-square score
+    int eg = 0;    // endgame material + piece-square score
+    int phase = 0; // 0 = bare kings and pawns, MAX_PHASE = all pieces on board
 };
+constexpr int MAX_PHASE = 24;
+// Irreversible part of a position saved by make_move - 24 bytes
 struct GameState
 {
-    int castling_rights;
-    Bitboard enpassant_square;
-    int halfmove_clock;
     uint64_t zobrist_position_key;
+    EvalTerms eval_terms;
+    uint16_t halfmove_clock;
+    uint8_t castling_rights;
+    int8_t enpassant_file; // -1 = none, rank follows from the side to move
 };
+static_assert(sizeof(GameState) == 24, "GameState should stay compact");
 enum Status
 {
     ONGOING,
@@ -1,40 +1,48 @@
 #include "Zobrist.hpp"
 
-uint64_t piece_keys[13][64];
-uint64_t castling_keys[16];
-uint64_t enpassant_keys[8];
-uint64_t side_key;
-
-static uint64_t seed = 694202137ULL;
-
-// Pseudo-random number generator (SplitMix64)
-uint64_t get_random_number()
+namespace
 {
-    uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
-    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
-    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
-    return z ^ (z >> 31);
-}
+    constexpr uint64_t ZOBRIST_SEED = 694202137ULL;
 
-void init_zobrist()
-{
-    for (int i = 1; i < 13; i++)
+    // index-th output of SplitMix64 started at ZOBRIST_SEED - the generator state after
+    // n calls is just seed + n * gamma, so every key can be computed independently
+    constexpr uint64_t zobrist_random(int index)
     {
-        for (int j = 0; j < 64; j++)
-        {
-            piece_keys[i][j] = get_random_number();
-        }
+        uint64_t z = ZOBRIST_SEED + (static_cast<uint64_t>(index) + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
     }
-    for (int i = 0; i < 16; i++)
+
+    // Keys are drawn in this order: pieces 1-12 (by square), castling, en passant, side
+    constexpr int CASTLING_OFFSET = 12 * 64;
+    constexpr int ENPASSANT_OFFSET = CASTLING_OFFSET + 16;
+    constexpr int SIDE_OFFSET = ENPASSANT_OFFSET + 8;
+
+    constexpr std::array<std::array<uint64_t, 64>, 13> make_piece_keys()
     {
-        castling_keys[i] = get_random_number();
+        std::array<std::array<uint64_t, 64>, 13> keys{};
+        for (int i = 1; i < 13; i++)
+            for (int j = 0; j < 64; j++)
+                keys[i][j] = zobrist_random((i - 1) * 64 + j);
+        return keys;
     }
-    for (int i = 0; i < 8; i++)
+
+    template <size_t N>
+    constexpr std::array<uint64_t, N> make_keys(int offset)
     {
-        enpassant_keys[i] = get_random_number();
+        std::array<uint64_t, N> keys{};
+        for (size_t i = 0; i < N; i++)
+            keys[i] = zobrist_random(offset + static_cast<int>(i));
+        return keys;
     }
-    side_key = get_random_number();
 }
+
+constexpr std::array<std::array<uint64_t, 64>, 13> piece_keys = make_piece_keys();
+constexpr std::array<uint64_t, 16> castling_keys = make_keys<16>(CASTLING_OFFSET);
+constexpr std::array<uint64_t, 8> enpassant_keys = make_keys<8>(ENPASSANT_OFFSET);
+constexpr uint64_t side_key = zobrist_random(SIDE_OFFSET);
+
 uint64_t hash_position(Board &board)
 {
     uint64_t key = 0ULL;
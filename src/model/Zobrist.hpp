@@ -1,13 +1,14 @@
 #ifndef ZOBRIST_HPP
 #define ZOBRIST_HPP
 
+#include <array>
 #include <cstdint>
 #include "Board.hpp"
-extern uint64_t piece_keys[13][64];
-extern uint64_t castling_keys[16];
-extern uint64_t enpassant_keys[8];
-extern uint64_t side_key;
+// Compile-time keys (constexpr definitions in Zobrist.cpp); piece_keys[EMPTY] stays zero
+extern const std::array<std::array<uint64_t, 64>, 13> piece_keys;
+extern const std::array<uint64_t, 16> castling_keys;
+extern const std::array<uint64_t, 8> enpassant_keys;
+extern const uint64_t side_key;
 
-void init_zobrist();
 uint64_t hash_position(Board &board);
 #endif
@@ -0,0 +1,493 @@
+// Headless perft runner - no SFML dependency.
+//
+// Usage:
+//   perft suite <file.epd> [--depth N] [--threads N] [--hash MB]
+//   perft divide "<fen>" <depth>
+//   perft run "<fen>" <depth> [--threads N] [--hash MB]
+//   perft verify "<fen>" <depth>
+//   perft stress <file.epd> [--depth N] [--threads N]
+//   perft compare "<fen>" <depth>
+//   perft fuzz <file.epd> [--positions N]
+//
+// Suite lines: <FEN> ;D1 <nodes> ;D2 <nodes> ...  ('#' starts a comment)
+// Exit code is non-zero if any count differs from the expected value.
+// verify walks the tree and checks at every node that the incrementally updated Zobrist key
+// and evaluation terms match a full recompute, that generate_captures + generate_quiets
+// split generate_moves exactly and that Board::gives_check agrees with playing each move
+// (non-zero exit code on a mismatch).
+// stress constructs boards on N threads at once and has every thread run the whole suite with
+// single-threaded perft (starting at a different position each) - meant for -DENGINE_TSAN=ON.
+// compare times single-threaded perft with make/undo and with copy-make (Position restore).
+// fuzz plays random games from the suite positions and checks at every position that
+// Board::is_pseudo_legal + is_legal accept exactly the moves of generate_moves, for the generated
+// moves (also with unused high bits set), moves seen in earlier positions and random encodings.
+#include "model/Board.hpp"
+#include "model/Evaluation.hpp"
+#include "model/FenParser.hpp"
+#include "model/MoveGenerator.hpp"
+#include "model/Notation.hpp"
+#include "model/Perft.hpp"
+#include "model/Zobrist.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        int max_depth = 5;
+        int threads = 1;
+        size_t hash_mb = 0;
+        long long positions = 1000000;
+    };
+
+    struct SuiteEntry
+    {
+        std::string fen;
+        std::vector<std::pair<int, long long>> expected; // (depth, nodes)
+    };
+
+    void print_usage()
+    {
+        std::cerr << "Usage:\n"
+                  << "  perft suite <file.epd> [--depth N] [--threads N] [--hash MB]\n"
+                  << "  perft divide \"<fen>\" <depth>\n"
+                  << "  perft run \"<fen>\" <depth> [--threads N] [--hash MB]\n"
+                  << "  perft verify \"<fen>\" <depth>\n"
+                  << "  perft stress <file.epd> [--depth N] [--threads N]\n"
+                  << "  perft compare \"<fen>\" <depth>\n"
+                  << "  perft fuzz <file.epd> [--positions N]\n";
+    }
+
+    // Parses trailing --depth/--threads/--hash flags starting at argv[first]
+    bool parse_options(int argc, char **argv, int first, Options &options)
+    {
+        for (int i = first; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            if (arg == "--depth")
+                options.max_depth = std::stoi(argv[++i]);
+            else if (arg == "--threads")
+                options.threads = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--hash")
+                options.hash_mb = std::stoul(argv[++i]);
+            else if (arg == "--positions")
+                options.positions = std::stoll(argv[++i]);
+            else
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<SuiteEntry> load_suite(const std::string &path)
+    {
+        std::vector<SuiteEntry> suite;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            SuiteEntry entry;
+            std::stringstream ss(line);
+            std::getline(ss, entry.fen, ';');
+            std::string field;
+            while (std::getline(ss, field, ';'))
+            {
+                std::stringstream fs(field);
+                std::string tag;
+                long long nodes;
+                if (fs >> tag >> nodes && tag.size() > 1 && tag[0] == 'D')
+                    entry.expected.emplace_back(std::stoi(tag.substr(1)), nodes);
+            }
+            suite.push_back(entry);
+        }
+        return suite;
+    }
+
+    PerftResult run_perft(const Board &board, int depth, const Options &options, PerftTable *table)
+    {
+        if (table)
+            table->clear();
+        return perft_parallel(board, depth, options.threads, table);
+    }
+
+    int run_suite(const std::string &path, const Options &options)
+    {
+        std::vector<SuiteEntry> suite = load_suite(path);
+        if (suite.empty())
+        {
+            std::cerr << "No positions loaded from " << path << "\n";
+            return 1;
+        }
+
+        std::unique_ptr<PerftTable> table;
+        if (options.hash_mb)
+            table = std::make_unique<PerftTable>(options.hash_mb);
+
+        Board board;
+        long long total_nodes = 0;
+        double total_seconds = 0.0;
+        int failures = 0;
+
+        for (size_t i = 0; i < suite.size(); i++)
+        {
+            const SuiteEntry &entry = suite[i];
+            load_fen_position(board, entry.fen);
+            std::cout << "Position " << i + 1 << ": " << entry.fen << "\n";
+
+            for (const auto &[depth, expected] : entry.expected)
+            {
+                if (depth > options.max_depth)
+                    continue;
+                PerftResult result = run_perft(board, depth, options, table.get());
+                bool ok = result.nodes == expected;
+                failures += !ok;
+                total_nodes += result.nodes;
+                total_seconds += result.seconds;
+
+                std::cout << "  depth " << depth << ": " << result.nodes
+                          << (ok ? " OK" : " FAIL (expected " + std::to_string(expected) + ")")
+                          << "  " << result.seconds << "s  NPS: "
+                          << static_cast<long long>(result.seconds > 0 ? result.nodes / result.seconds : 0) << "\n";
+            }
+        }
+
+        std::cout << "Total: " << total_nodes << " nodes, " << total_seconds << "s, NPS: "
+                  << static_cast<long long>(total_seconds > 0 ? total_nodes / total_seconds : 0) << "\n";
+        std::cout << (failures ? std::to_string(failures) + " FAILED" : std::string("All passed")) << "\n";
+        return failures ? 1 : 0;
+    }
+
+    int run_stress(const std::string &path, const Options &options)
+    {
+        std::vector<SuiteEntry> suite = load_suite(path);
+        if (suite.empty())
+        {
+            std::cerr << "No positions loaded from " << path << "\n";
+            return 1;
+        }
+
+        std::atomic<long long> total_nodes{0};
+        std::atomic<int> failures{0};
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < options.threads; t++)
+            threads.emplace_back([&, t]
+                                 {
+                for (size_t n = 0; n < suite.size(); n++)
+                {
+                    const SuiteEntry &entry = suite[(n + t) % suite.size()];
+                    Board board;
+                    load_fen_position(board, entry.fen);
+                    for (const auto &[depth, expected] : entry.expected)
+                    {
+                        if (depth > options.max_depth)
+                            continue;
+                        long long nodes = MoveGenerator::perft(board, depth);
+                        total_nodes += nodes;
+                        bool ok = nodes == expected;
+                        // The board's lazily computed move list must agree as well
+                        if (depth == 1)
+                            ok = ok && board.get_legal_moves().size() == expected;
+                        if (!ok)
+                        {
+                            failures++;
+                            std::cout << "FAIL (thread " + std::to_string(t) + ", depth " + std::to_string(depth) + "): " + entry.fen + "\n";
+                        }
+                    }
+                } });
+        for (std::thread &thread : threads)
+            thread.join();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << options.threads << " threads x " << suite.size() << " positions: " << total_nodes << " nodes, "
+                  << seconds << "s\n";
+        std::cout << (failures ? std::to_string(failures) + " FAILED" : std::string("All passed")) << "\n";
+        return failures ? 1 : 0;
+    }
+
+    int run_divide(const std::string &fen, int depth)
+    {
+        if (depth < 1)
+        {
+            std::cerr << "Divide depth must be at least 1\n";
+            return 2;
+        }
+        Board board;
+        load_fen_position(board, fen);
+        MoveList moves;
+        MoveGenerator::generate_moves(board, moves);
+
+        auto start = std::chrono::steady_clock::now();
+        long long total = 0;
+        for (const Move &move : moves)
+        {
+            board.make_move(move);
+            long long nodes = MoveGenerator::perft(board, depth - 1);
+            board.undo_move(move);
+            total += nodes;
+            std::cout << move_to_uci(move) << ": " << nodes << "\n";
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "\nMoves: " << moves.size() << "\nNodes: " << total << "\nTime: " << seconds << "s\n";
+        return 0;
+    }
+
+    int run_compare(const std::string &fen, int depth)
+    {
+        using Perft = long long (*)(Board &, int);
+        const std::pair<const char *, Perft> modes[] = {{"make/undo", MoveGenerator::perft},
+                                                        {"copy-make", MoveGenerator::perft_copy_make}};
+        long long counts[2];
+        for (int i = 0; i < 2; i++)
+        {
+            Board board;
+            load_fen_position(board, fen);
+            auto start = std::chrono::steady_clock::now();
+            counts[i] = modes[i].second(board, depth);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << modes[i].first << ": " << counts[i] << " nodes, " << seconds << "s, NPS: "
+                      << static_cast<long long>(seconds > 0 ? counts[i] / seconds : 0) << "\n";
+        }
+        return counts[0] == counts[1] ? 0 : 1;
+    }
+
+    uint64_t next_random(uint64_t &state)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    int run_fuzz(const std::string &path, const Options &options)
+    {
+        constexpr int MAX_GAME_PLIES = 200;
+        constexpr int RECENT_MOVES = 64;
+        constexpr int RANDOM_MOVES = 16;
+
+        std::vector<SuiteEntry> suite = load_suite(path);
+        if (suite.empty())
+        {
+            std::cerr << "No positions loaded from " << path << "\n";
+            return 1;
+        }
+
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        Move recent[RECENT_MOVES] = {};
+        long long positions = 0, checked = 0, accepted = 0, failures = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        Board board;
+        MoveList moves;
+        for (size_t game = 0; positions < options.positions; game++)
+        {
+            const std::string &fen = suite[game % suite.size()].fen;
+            load_fen_position(board, fen);
+            std::string played;
+
+            for (int ply = 0; ply < MAX_GAME_PLIES && positions < options.positions; ply++)
+            {
+                MoveGenerator::generate_moves(board, moves);
+                positions++;
+
+                auto check = [&](const Move &move)
+                {
+                    uint64_t key = board.get_zobrist_key();
+                    bool legal = board.is_pseudo_legal(move) && board.is_legal(move);
+                    bool generated = std::find(moves.begin(), moves.end(), move) != moves.end();
+                    checked++;
+                    accepted += legal;
+                    if (legal != generated || board.get_zobrist_key() != key)
+                    {
+                        failures++;
+                        std::cout << "FAIL: move 0x" << std::hex << move.data << std::dec << " (" << move_to_uci(move)
+                                  << ") " << (legal ? "accepted" : "rejected") << " after \"" << fen << "\" moves" << played << "\n";
+                    }
+                };
+
+                for (const Move &move : moves)
+                {
+                    check(move);
+                    // The same move with one of the unused high bits (27-31) set
+                    Move tagged = move;
+                    tagged.data |= 1u << (27 + next_random(state) % 5);
+                    check(tagged);
+                }
+                // Stale moves, as from the hash table or killer slots
+                for (const Move &move : recent)
+                    if (move.data)
+                        check(move);
+                // Random encodings - half of them with our piece on the source square, the other half
+                // over all 32 bits or only the 27 used ones
+                Bitboard own = board.get_pieces(board.is_white_to_move() ? WHITE : BLACK);
+                for (int i = 0; i < RANDOM_MOVES; i++)
+                {
+                    uint64_t r = next_random(state);
+                    Move move;
+                    if (i & 1)
+                        move.data = static_cast<uint32_t>(r) & (i & 2 ? 0xFFFFFFFFu : 0x7FFFFFFu);
+                    else
+                    {
+                        int source = __builtin_ctzll(own);
+                        for (int skip = static_cast<int>(r % __builtin_popcountll(own)); skip > 0; skip--)
+                            source = __builtin_ctzll(own & ~((2ULL << source) - 1));
+                        int target = static_cast<int>((r >> 8) & 63);
+                        int promotion = (r >> 16) % 8 == 0 ? static_cast<int>((r >> 20) % 13) : 0;
+                        int flags = (r >> 24) % 16;
+                        move = Move(source, target, board.get_piece_at(source), board.get_piece_at(target), promotion,
+                                    flags == 1, flags >= 14 ? flags - 13 : 0);
+                    }
+                    check(move);
+                }
+
+                if (moves.empty() || board.get_halfmove_clock() >= 100)
+                    break;
+                Move move = moves[static_cast<int>(next_random(state) % moves.size())];
+                recent[positions % RECENT_MOVES] = move;
+                played += " " + move_to_uci(move);
+                board.make_move(move);
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << positions << " positions, " << checked << " moves checked (" << accepted << " legal), " << seconds << "s\n";
+        std::cout << (failures ? std::to_string(failures) + " FAILED" : std::string("All passed")) << "\n";
+        return failures ? 1 : 0;
+    }
+
+    int run_single(const std::string &fen, int depth, const Options &options)
+    {
+        Board board;
+        load_fen_position(board, fen);
+        std::unique_ptr<PerftTable> table;
+        if (options.hash_mb)
+            table = std::make_unique<PerftTable>(options.hash_mb);
+
+        PerftResult result = run_perft(board, depth, options, table.get());
+        std::cout << "Nodes: " << result.nodes << "\nTime: " << result.seconds << "s\nNPS: "
+                  << static_cast<long long>(result.seconds > 0 ? result.nodes / result.seconds : 0) << "\n";
+        return 0;
+    }
+
+    bool incremental_state_ok(Board &board)
+    {
+        EvalTerms expected = compute_eval_terms(board);
+        const EvalTerms &actual = board.get_eval_terms();
+        return board.get_zobrist_key() == hash_position(board) && actual.mg == expected.mg &&
+               actual.eg == expected.eg && actual.phase == expected.phase;
+    }
+
+    // Captures and quiets must be disjoint and together give exactly the full move list
+    bool staged_generation_ok(Board &board, const MoveList &moves)
+    {
+        MoveList captures, quiets;
+        MoveGenerator::generate_captures(board, captures);
+        MoveGenerator::generate_quiets(board, quiets);
+        std::vector<uint32_t> all, staged;
+        for (const Move &move : moves)
+            all.push_back(move.data);
+        for (const Move &move : captures)
+        {
+            if (!move.captured() && !move.promotion())
+                return false;
+            staged.push_back(move.data);
+        }
+        for (const Move &move : quiets)
+        {
+            if (move.captured() || move.promotion())
+                return false;
+            staged.push_back(move.data);
+        }
+        std::sort(all.begin(), all.end());
+        std::sort(staged.begin(), staged.end());
+        return all == staged;
+    }
+
+    // Returns the number of nodes whose incremental state or staged generation is wrong
+    long long verify_incremental(Board &board, int depth)
+    {
+        long long errors = 0;
+        MoveList moves;
+        MoveGenerator::generate_moves(board, moves);
+        if (!staged_generation_ok(board, moves))
+        {
+            std::cout << "Staged generation mismatch\n";
+            errors++;
+        }
+        for (const Move &move : moves)
+        {
+            bool gives_check = board.gives_check(move);
+            board.make_move(move);
+            if (!incremental_state_ok(board))
+            {
+                std::cout << "Mismatch after " << move_to_uci(move) << "\n";
+                errors++;
+            }
+            if (gives_check != board.in_check())
+            {
+                std::cout << "gives_check wrong for " << move_to_uci(move) << "\n";
+                errors++;
+            }
+            if (depth > 1)
+                errors += verify_incremental(board, depth - 1);
+            board.undo_move(move);
+        }
+        if (!incremental_state_ok(board))
+            errors++;
+        return errors;
+    }
+
+    int run_verify(const std::string &fen, int depth)
+    {
+        Board board;
+        load_fen_position(board, fen);
+        long long errors = verify_incremental(board, std::max(1, depth));
+        std::cout << (errors ? std::to_string(errors) + " mismatches" : std::string("Incremental state, staged generation and gives_check OK")) << "\n";
+        return errors ? 1 : 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+    Options options;
+
+    if (command == "suite" && parse_options(argc, argv, 3, options))
+        return run_suite(argv[2], options);
+    if (command == "divide" && argc == 4)
+        return run_divide(argv[2], std::stoi(argv[3]));
+    if (command == "run" && argc >= 4 && parse_options(argc, argv, 4, options))
+        return run_single(argv[2], std::stoi(argv[3]), options);
+    if (command == "stress" && parse_options(argc, argv, 3, options))
+        return run_stress(argv[2], options);
+    if (command == "fuzz" && parse_options(argc, argv, 3, options))
+        return run_fuzz(argv[2], options);
+    if (command == "compare" && argc == 4)
+        return run_compare(argv[2], std::stoi(argv[3]));
+    if (command == "verify" && argc == 4)
+        return run_verify(argv[2], std::stoi(argv[3]));
+
+    print_usage();
+    return 2;
+}
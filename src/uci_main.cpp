@@ -0,0 +1,375 @@
+// Headless UCI engine - no SFML dependency.
+//
+// Speaks the Universal Chess Interface on stdin/stdout:
+//   uci, isready, ucinewgame, quit
+//   setoption name Hash|Threads|Ponder|EvalFile value <x>
+//   position startpos|fen <fen> [moves <uci moves>]
+//   go [depth N] [nodes N] [movetime MS] [wtime MS] [btime MS] [winc MS] [binc MS] [movestogo N] [infinite] [ponder]
+//   stop, ponderhit
+//   bench [depth]
+// The search runs on a worker thread, so stop / ponderhit / isready are answered while it runs.
+#include "model/Bench.hpp"
+#include "model/Board.hpp"
+#include "model/FenParser.hpp"
+#include "model/Notation.hpp"
+#include "model/SearchPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int DEFAULT_HASH_MB = 16;
+    constexpr int MAX_HASH_MB = 65536;
+    constexpr int MAX_THREADS = 512;
+    constexpr int BENCH_DEPTH = 6;
+    // Reserved for GUI / network lag when the budget is derived from the clock
+    constexpr int MOVE_OVERHEAD_MS = 30;
+    // Moves left in the game assumed when the GUI does not send movestogo
+    constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+    // The worker thread prints info/bestmove while the input thread answers commands
+    std::mutex output_mutex;
+    void send(const std::string &line)
+    {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cout << line << std::endl;
+    }
+
+    // Time for one move from the remaining clock and increment
+    int time_budget(int time_ms, int increment_ms, int moves_to_go)
+    {
+        int moves = moves_to_go > 0 ? moves_to_go : DEFAULT_MOVES_TO_GO;
+        int budget = time_ms / moves + increment_ms * 3 / 4;
+        return std::max(1, std::min(budget, time_ms - MOVE_OVERHEAD_MS));
+    }
+
+    // Whole string must be a number that fits into an int
+    bool parse_int(const std::string &text, int &value)
+    {
+        const char *end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, value);
+        return error == std::errc() && ptr == end;
+    }
+
+    std::string format_score(int score)
+    {
+        if (score >= MATE_BOUND)
+            return "mate " + std::to_string((MATE_SCORE - score + 1) / 2);
+        if (score <= -MATE_BOUND)
+            return "mate -" + std::to_string((MATE_SCORE + score) / 2);
+        return "cp " + std::to_string(score);
+    }
+
+    std::string format_info(const SearchInfo &info)
+    {
+        std::string line = "info depth " + std::to_string(info.depth) + " score " + format_score(info.score) +
+                           " nodes " + std::to_string(info.nodes) + " nps " + std::to_string(info.nps) +
+                           " time " + std::to_string(static_cast<long long>(info.seconds * 1000)) +
+                           " hashfull " + std::to_string(info.hashfull) + " pv";
+        for (const Move &move : info.pv)
+            line += " " + move_to_uci(move);
+        return line;
+    }
+
+    class UciEngine
+    {
+    public:
+        UciEngine() : table(DEFAULT_HASH_MB), pool(table) {}
+        ~UciEngine() { stop_search(); }
+
+        void loop();
+
+    private:
+        void handle_position(std::istringstream &input);
+        void handle_go(std::istringstream &input);
+        void handle_setoption(std::istringstream &input);
+        void handle_bench(std::istringstream &input);
+        void handle_ponderhit();
+
+        void start_search(const SearchLimits &limits, bool wait_for_stop, int ponder_budget_ms);
+        // Ends the running search (if any) and waits for its bestmove
+        void stop_search();
+        void request_stop();
+
+        TranspositionTable table;
+        SearchPool pool;
+        NnueNetwork network;
+        Board board;
+
+        std::thread worker;
+        std::thread timer; // ponderhit deadline
+        std::mutex mutex;
+        std::condition_variable state_changed;
+        // Set by stop/quit; also re-checked after every iteration, since a stop that arrives
+        // before the pool has started would otherwise be cleared by SearchPool::search
+        std::atomic<bool> stop_requested{false};
+        bool searching = false;
+        bool wait_for_stop = false; // go infinite / go ponder: bestmove only after stop or ponderhit
+        bool pondering = false;
+        int ponder_budget_ms = 0;
+    };
+
+    void UciEngine::loop()
+    {
+        std::string line;
+        while (std::getline(std::cin, line))
+        {
+            std::istringstream input(line);
+            std::string command;
+            input >> command;
+
+            if (command == "uci")
+            {
+                send("id name Chess Engine");
+                send("id author Chess Engine contributors");
+                send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " + std::to_string(MAX_HASH_MB));
+                send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+                send("option name Ponder type check default false");
+                send("option name EvalFile type string default <empty>");
+                send("uciok");
+            }
+            else if (command == "isready")
+                send("readyok");
+            else if (command == "ucinewgame")
+            {
+                stop_search();
+                table.clear();
+            }
+            else if (command == "setoption")
+                handle_setoption(input);
+            else if (command == "position")
+                handle_position(input);
+            else if (command == "go")
+                handle_go(input);
+            else if (command == "stop")
+                request_stop();
+            else if (command == "ponderhit")
+                handle_ponderhit();
+            else if (command == "bench")
+                handle_bench(input);
+            else if (command == "quit")
+                break;
+        }
+        stop_search();
+    }
+
+    void UciEngine::handle_position(std::istringstream &input)
+    {
+        std::string token, fen;
+        input >> token;
+        if (token == "startpos")
+        {
+            fen = board.starting_fen;
+            input >> token; // "moves"
+        }
+        else if (token == "fen")
+        {
+            while (input >> token && token != "moves")
+                fen += token + " ";
+        }
+        else
+            return;
+
+        load_fen_position(board, fen);
+        while (input >> token)
+        {
+            Move move = uci_to_move(board, token);
+            if (!move.data)
+            {
+                send("info string illegal move " + token);
+                break;
+            }
+            board.make_move(move);
+        }
+    }
+
+    void UciEngine::handle_go(std::istringstream &input)
+    {
+        SearchLimits limits;
+        int time_ms[2] = {-1, -1};
+        int increment_ms[2] = {0, 0};
+        int moves_to_go = 0;
+        bool infinite = false, ponder = false;
+
+        std::string token;
+        while (input >> token)
+        {
+            if (token == "depth")
+                input >> limits.depth;
+            else if (token == "nodes")
+                input >> limits.nodes;
+            else if (token == "movetime")
+                input >> limits.movetime_ms;
+            else if (token == "wtime")
+                input >> time_ms[WHITE];
+            else if (token == "btime")
+                input >> time_ms[BLACK];
+            else if (token == "winc")
+                input >> increment_ms[WHITE];
+            else if (token == "binc")
+                input >> increment_ms[BLACK];
+            else if (token == "movestogo")
+                input >> moves_to_go;
+            else if (token == "infinite")
+                infinite = true;
+            else if (token == "ponder")
+                ponder = true;
+        }
+
+        int us = board.is_white_to_move() ? WHITE : BLACK;
+        int budget_ms = 0;
+        if (limits.movetime_ms)
+            budget_ms = limits.movetime_ms;
+        else if (time_ms[us] >= 0)
+            budget_ms = time_budget(time_ms[us], increment_ms[us], moves_to_go);
+
+        // Pondering searches without a clock - the budget starts at ponderhit
+        limits.movetime_ms = infinite || ponder ? 0 : budget_ms;
+        start_search(limits, infinite || ponder, ponder ? budget_ms : 0);
+    }
+
+    void UciEngine::handle_setoption(std::istringstream &input)
+    {
+        std::string token, name, value;
+        input >> token; // "name"
+        while (input >> token && token != "value")
+            name += (name.empty() ? "" : " ") + token;
+        input >> value;
+
+        stop_search();
+        int number = 0;
+        if (name == "Hash" || name == "Threads")
+        {
+            // A malformed value keeps the current setting
+            if (!parse_int(value, number))
+                send("info string invalid value '" + value + "' for " + name + ", keeping the current setting");
+            else if (name == "Hash")
+                table.resize(std::clamp(number, 1, MAX_HASH_MB));
+            else
+                pool.set_threads(std::clamp(number, 1, MAX_THREADS));
+        }
+        else if (name == "EvalFile")
+        {
+            // A failed load keeps the previous network (or the classical evaluation)
+            if (value.empty() || value == "<empty>")
+                pool.set_network(nullptr);
+            else if (network.load(value))
+            {
+                pool.set_network(&network);
+                send("info string NNUE evaluation using " + value + " (" + NnueNetwork::backend_name(network.get_backend()) + ")");
+            }
+            else
+                send("info string cannot load " + value + (network.is_loaded() ? ", keeping the previous network" : ", using the classical evaluation"));
+        }
+    }
+
+    void UciEngine::handle_bench(std::istringstream &input)
+    {
+        int depth = BENCH_DEPTH;
+        input >> depth;
+        stop_search();
+
+        BenchResult result = run_bench(pool, table, std::max(1, depth), [](const std::string &fen, Move best, double seconds)
+                                       { send("info string " + move_to_uci(best) + " " + std::to_string(seconds) + "s " + fen); });
+        table.clear();
+        send("Nodes searched: " + std::to_string(result.nodes));
+        send("Nodes/second: " + std::to_string(result.seconds > 0 ? static_cast<long long>(result.nodes / result.seconds) : 0));
+    }
+
+    void UciEngine::handle_ponderhit()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!searching || !pondering)
+            return;
+        pondering = false;
+        wait_for_stop = false;
+        state_changed.notify_all();
+
+        // The opponent played the expected move - the search continues on our clock
+        if (ponder_budget_ms > 0)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ponder_budget_ms);
+            timer = std::thread([this, deadline]
+                                {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!state_changed.wait_until(lock, deadline, [this] { return !searching; }))
+                    pool.stop(); });
+        }
+    }
+
+    void UciEngine::start_search(const SearchLimits &limits, bool wait, int budget_ms)
+    {
+        stop_search();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop_requested = false;
+            searching = true;
+            wait_for_stop = wait;
+            pondering = budget_ms > 0;
+            ponder_budget_ms = budget_ms;
+        }
+
+        worker = std::thread([this, limits, position = board]
+                             {
+            std::vector<Move> pv;
+            Move best = pool.search(position, limits, [&](const SearchInfo &info)
+                                    {
+                if (stop_requested)
+                    pool.stop();
+                pv = info.pv;
+                send(format_info(info)); });
+
+            // go infinite / go ponder must not answer before stop or ponderhit
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                state_changed.wait(lock, [this] { return stop_requested || !wait_for_stop; });
+                searching = false;
+            }
+            state_changed.notify_all();
+
+            std::string line = "bestmove " + (best.data ? move_to_uci(best) : std::string("0000"));
+            if (best.data && pv.size() > 1 && pv[0] == best)
+                line += " ponder " + move_to_uci(pv[1]);
+            send(line); });
+    }
+
+    void UciEngine::request_stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!searching)
+                return;
+            stop_requested = true;
+        }
+        state_changed.notify_all();
+        pool.stop();
+    }
+
+    void UciEngine::stop_search()
+    {
+        request_stop();
+        if (worker.joinable())
+            worker.join();
+        if (timer.joinable())
+            timer.join();
+    }
+}
+
+int main()
+{
+    std::ios::sync_with_stdio(false);
+    // Reading must not flush std::cout behind the back of send() while the worker prints
+    std::cin.tie(nullptr);
+    UciEngine engine;
+    engine.loop();
+    return 0;
+}
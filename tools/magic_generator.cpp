@@ -1,14 +1,22 @@
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <immintrin.h>
 #include <iostream>
 #include <random>
+#include <string>
 #include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 using Bitboard = std::uint64_t;
 
 static int popcount(Bitboard b) { return __builtin_popcountll(b); }
-static int lsb(Bitboard b) { return __builtin_ctzll(b); }
 
 static Bitboard set_bit(int sq) { return 1ULL << sq; }
 static int file_of(int sq) { return sq & 7; }
@@ -122,9 +130,12 @@ static std::vector<Bitboard> enumerate_occupancies(Bitboard mask)
 
 struct MagicData
 {
+    Bitboard mask;
     Bitboard magic;
     int shift;
     int offset;
+    std::vector<Bitboard> table;      // indexed by magic index
+    std::vector<Bitboard> pext_table; // indexed by pext(occupancy, mask)
 };
 
 static Bitboard random_magic(std::mt19937_64 &rng)
@@ -159,155 +170,229 @@ static MagicData find_magic(int sq, bool rook, const std::vector<Bitboard> &occu
             }
         }
         if (!fail)
-            return {magic, 64 - relevant_bits, 0};
+            return {rook ? rook_mask(sq) : bishop_mask(sq), magic, 64 - relevant_bits, 0, table, {}};
     }
 }
 
-int main()
+// Finds the magic for every square and fills its (fancy, 1 << relevant bits) attack table
+static std::vector<MagicData> find_magics(bool rook, std::mt19937_64 &rng)
 {
-    std::mt19937_64 rng(0xC0FFEEULL);
-
-    std::vector<MagicData> rook_data(64), bishop_data(64);
-    std::vector<int> rook_bits(64), bishop_bits(64);
-
-    // Plain magic tables: each square has its own table [64][1<<bits]
-    std::vector<std::vector<Bitboard>> rook_tables(64), bishop_tables(64);
-
+    std::vector<MagicData> data(64);
     for (int sq = 0; sq < 64; ++sq)
     {
-        Bitboard mask = rook_mask(sq);
-        auto occs = enumerate_occupancies(mask);
+        auto occs = enumerate_occupancies(rook ? rook_mask(sq) : bishop_mask(sq));
         std::vector<Bitboard> attacks(occs.size());
         for (std::size_t i = 0; i < occs.size(); ++i)
-            attacks[i] = rook_attack_on_the_fly(sq, occs[i]);
-        rook_bits[sq] = popcount(mask);
-        auto m = find_magic(sq, true, occs, attacks, rng);
-        rook_data[sq] = m;
-
-        // Build plain table for this square
-        int table_size = 1 << rook_bits[sq];
-        rook_tables[sq].resize(table_size, 0ULL);
-        for (std::size_t i = 0; i < occs.size(); ++i)
-        {
-            Bitboard idx = (occs[i] * m.magic) >> m.shift;
-            rook_tables[sq][idx] = attacks[i];
-        }
+            attacks[i] = rook ? rook_attack_on_the_fly(sq, occs[i]) : bishop_attack_on_the_fly(sq, occs[i]);
+        data[sq] = find_magic(sq, rook, occs, attacks, rng);
+        // Subsets are enumerated in increasing order, which is exactly pext index order
+        data[sq].pext_table = attacks;
     }
+    return data;
+}
 
-    for (int sq = 0; sq < 64; ++sq)
-    {
-        Bitboard mask = bishop_mask(sq);
-        auto occs = enumerate_occupancies(mask);
-        std::vector<Bitboard> attacks(occs.size());
-        for (std::size_t i = 0; i < occs.size(); ++i)
-            attacks[i] = bishop_attack_on_the_fly(sq, occs[i]);
-        bishop_bits[sq] = popcount(mask);
-        auto m = find_magic(sq, false, occs, attacks, rng);
-        bishop_data[sq] = m;
-
-        // Build plain table for this square
-        int table_size = 1 << bishop_bits[sq];
-        bishop_tables[sq].resize(table_size, 0ULL);
-        for (std::size_t i = 0; i < occs.size(); ++i)
+// Fancy magics: every square's table is exactly 1 << relevant bits long, stored back to back
+// (rooks, then bishops) in one array. The magics found here use every slot of their table,
+// so tables cannot be overlapped any further. PEXT tables have the same sizes and offsets.
+static std::vector<Bitboard> pack_tables(std::vector<MagicData> &rook, std::vector<MagicData> &bishop, bool pext)
+{
+    std::vector<Bitboard> packed;
+    for (std::vector<MagicData> *data : {&rook, &bishop})
+        for (MagicData &m : *data)
         {
-            Bitboard idx = (occs[i] * m.magic) >> m.shift;
-            bishop_tables[sq][idx] = attacks[i];
+            const std::vector<Bitboard> &table = pext ? m.pext_table : m.table;
+            m.offset = static_cast<int>(packed.size());
+            packed.insert(packed.end(), table.begin(), table.end());
         }
-    }
+    return packed;
+}
 
-    auto print_int_array = [](const char *name, const std::vector<int> &arr)
-    {
-        std::cout << "const int " << name << "[64] = {\n    ";
-        for (int i = 0; i < 64; ++i)
-        {
-            std::cout << arr[i];
-            if (i != 63)
-                std::cout << ", ";
-            if ((i + 1) % 8 == 0)
-                std::cout << "\n    ";
-        }
-        std::cout << "};\n\n";
-    };
+__attribute__((target("bmi2"))) static Bitboard pext(Bitboard value, Bitboard mask)
+{
+    return _pext_u64(value, mask);
+}
 
-    auto print_2d_table = [](const char *name, const std::vector<std::vector<Bitboard>> &tables, int max_size)
+// Hardware cache-miss counter for this thread; reports -1 when perf events are unavailable
+class MissCounter
+{
+public:
+    MissCounter(std::uint32_t type, std::uint64_t config)
     {
-        std::cout << "const Bitboard " << name << "[64][" << max_size << "] = {\n";
-        for (int sq = 0; sq < 64; ++sq)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~MissCounter()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+    void start()
+    {
+        if (fd >= 0)
         {
-            std::cout << "    {";
-            for (int i = 0; i < max_size; ++i)
-            {
-                if (i % 4 == 0 && i > 0)
-                    std::cout << "\n     ";
-                if (i < static_cast<int>(tables[sq].size()))
-                    std::cout << "0x" << std::hex << std::setw(16) << std::setfill('0') << tables[sq][i] << std::dec;
-                else
-                    std::cout << "0x0000000000000000";
-                if (i + 1 != max_size)
-                    std::cout << ",";
-            }
-            std::cout << "}";
-            if (sq != 63)
-                std::cout << ",";
-            std::cout << "\n";
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
         }
-        std::cout << "};\n\n";
-    };
-
-    // Print shifts (64 - relevant bits)
-    std::vector<int> rook_shifts(64), bishop_shifts(64);
-    for (int i = 0; i < 64; ++i)
+    }
+    long long stop()
     {
-        rook_shifts[i] = rook_data[i].shift;
-        bishop_shifts[i] = bishop_data[i].shift;
+        long long count = -1;
+        if (fd >= 0 && (ioctl(fd, PERF_EVENT_IOC_DISABLE, 0), read(fd, &count, sizeof(count)) != sizeof(count)))
+            count = -1;
+        return count;
     }
 
-    std::cout << "// Generated by tools/magic_generator.cpp (plain magics)\n";
-    std::cout << "namespace magics\n{\n\n";
+private:
+    int fd;
+};
+
+static constexpr int BENCH_LOOKUPS = 1 << 20;
+static constexpr int BENCH_ROUNDS = 20;
 
-    print_int_array("rook_shifts", rook_shifts);
-    print_int_array("bishop_shifts", bishop_shifts);
+// Compares the dense per-square layout ([64][4096] + [64][512]) with the packed one on the
+// same magics: footprint, lookup time and cache misses over random sliders and occupancies
+static int run_bench(std::vector<MagicData> &rook, std::vector<MagicData> &bishop)
+{
+    std::vector<Bitboard> pext_packed = pack_tables(rook, bishop, true);
+    std::vector<Bitboard> packed = pack_tables(rook, bishop, false);
 
-    std::vector<Bitboard> rook_magics(64), bishop_magics(64);
-    for (int i = 0; i < 64; ++i)
+    std::vector<Bitboard> dense_rook(64 * 4096, 0ULL), dense_bishop(64 * 512, 0ULL);
+    for (int sq = 0; sq < 64; ++sq)
     {
-        rook_magics[i] = rook_data[i].magic;
-        bishop_magics[i] = bishop_data[i].magic;
+        std::copy(rook[sq].table.begin(), rook[sq].table.end(), dense_rook.begin() + sq * 4096);
+        std::copy(bishop[sq].table.begin(), bishop[sq].table.end(), dense_bishop.begin() + sq * 512);
     }
 
-    std::cout << "const Bitboard rook_magics[64] = {\n    ";
-    for (int i = 0; i < 64; ++i)
+    // Occupancies with about as many pieces as a middlegame position
+    std::mt19937_64 rng(12345);
+    std::vector<int> squares(BENCH_LOOKUPS);
+    std::vector<Bitboard> occupancies(BENCH_LOOKUPS);
+    for (int i = 0; i < BENCH_LOOKUPS; ++i)
     {
-        std::cout << "0x" << std::hex << std::setw(16) << std::setfill('0') << rook_magics[i] << std::dec;
-        if (i != 63)
-            std::cout << ",";
-        if ((i + 1) % 4 == 0)
-            std::cout << "\n    ";
+        squares[i] = static_cast<int>(rng() & 63);
+        occupancies[i] = rng() & rng();
     }
-    std::cout << "\n};\n\n";
 
-    std::cout << "const Bitboard bishop_magics[64] = {\n    ";
-    for (int i = 0; i < 64; ++i)
+    auto dense_lookup = [&](int sq, Bitboard occ)
+    {
+        return dense_rook[sq * 4096 + (((occ & rook[sq].mask) * rook[sq].magic) >> rook[sq].shift)] |
+               dense_bishop[sq * 512 + (((occ & bishop[sq].mask) * bishop[sq].magic) >> bishop[sq].shift)];
+    };
+    auto packed_lookup = [&](int sq, Bitboard occ)
+    {
+        return packed[rook[sq].offset + (((occ & rook[sq].mask) * rook[sq].magic) >> rook[sq].shift)] |
+               packed[bishop[sq].offset + (((occ & bishop[sq].mask) * bishop[sq].magic) >> bishop[sq].shift)];
+    };
+
+    auto pext_lookup = [&](int sq, Bitboard occ)
+    {
+        return pext_packed[rook[sq].offset + pext(occ, rook[sq].mask)] |
+               pext_packed[bishop[sq].offset + pext(occ, bishop[sq].mask)];
+    };
+
+    auto measure = [&](const char *name, std::size_t bytes, auto lookup)
+    {
+        MissCounter l1_misses(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        MissCounter llc_misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        Bitboard checksum = 0;
+        l1_misses.start();
+        llc_misses.start();
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < BENCH_ROUNDS; ++round)
+            for (int i = 0; i < BENCH_LOOKUPS; ++i)
+                checksum ^= lookup(squares[i], occupancies[i] ^ checksum);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long l1 = l1_misses.stop(), llc = llc_misses.stop();
+
+        auto per_lookup = [](long long count)
+        { return count < 0 ? std::string("n/a") : std::to_string(static_cast<double>(count) / (BENCH_LOOKUPS * static_cast<double>(BENCH_ROUNDS))); };
+        std::cout << std::left << std::setw(8) << name << std::right << std::setw(9) << bytes / 1024 << " KB"
+                  << std::setw(10) << std::fixed << std::setprecision(2) << seconds * 1e9 / (BENCH_LOOKUPS * static_cast<double>(BENCH_ROUNDS)) << " ns"
+                  << "   L1d misses/lookup " << per_lookup(l1) << "   cache misses/lookup " << per_lookup(llc)
+                  << "   " << std::setprecision(0) << BENCH_LOOKUPS * static_cast<double>(BENCH_ROUNDS) / seconds / 1e6
+                  << "M lookups/s   (checksum " << std::hex << (checksum & 0xFFFF) << std::dec << ")\n";
+        return checksum;
+    };
+
+    std::cout << "Rook + bishop attacks, " << BENCH_LOOKUPS << " random lookups x " << BENCH_ROUNDS << " rounds\n";
+    Bitboard a = measure("dense", (dense_rook.size() + dense_bishop.size()) * sizeof(Bitboard), dense_lookup);
+    Bitboard b = measure("packed", packed.size() * sizeof(Bitboard), packed_lookup);
+    Bitboard c = b;
+    if (__builtin_cpu_supports("bmi2"))
+        c = measure("pext", pext_packed.size() * sizeof(Bitboard), pext_lookup);
+    else
+        std::cout << "pext     not supported by this CPU\n";
+    if (a != b || b != c)
     {
-        std::cout << "0x" << std::hex << std::setw(16) << std::setfill('0') << bishop_magics[i] << std::dec;
-        if (i != 63)
-            std::cout << ",";
-        if ((i + 1) % 4 == 0)
-            std::cout << "\n    ";
+        std::cerr << "Layouts disagree\n";
+        return 1;
     }
-    std::cout << "\n};\n\n";
+    return 0;
+}
 
-    print_2d_table("rook_attacks", rook_tables, 4096);
-    print_2d_table("bishop_attacks", bishop_tables, 512);
+// Usage:
+//   magic_generator [--pext] [output.cpp]  - writes a complete Magics.cpp (stdout if no path given);
+//                                            --pext orders the tables for BMI2 PEXT indexing
+//   magic_generator --bench                - compares dense, packed and PEXT lookups
+int main(int argc, char **argv)
+{
+    std::mt19937_64 rng(0xC0FFEEULL);
+    std::vector<MagicData> rook_data = find_magics(true, rng);
+    std::vector<MagicData> bishop_data = find_magics(false, rng);
 
-    std::cout << "} // namespace magics\n";
+    int arg = 1;
+    if (arg < argc && std::string(argv[arg]) == "--bench")
+        return run_bench(rook_data, bishop_data);
+    bool use_pext = arg < argc && std::string(argv[arg]) == "--pext";
+    arg += use_pext;
+    std::vector<Bitboard> packed = pack_tables(rook_data, bishop_data, use_pext);
 
-    long long rook_total = 0, bishop_total = 0;
-    for (int i = 0; i < 64; ++i)
+    std::ofstream file;
+    if (arg < argc)
+        file.open(argv[arg]);
+    std::ostream &out = arg < argc ? static_cast<std::ostream &>(file) : std::cout;
+
+    auto print_magics = [&out](const char *name, const std::vector<MagicData> &data)
     {
-        rook_total += rook_tables[i].size();
-        bishop_total += bishop_tables[i].size();
+        out << "const Magic " << name << "[64] = {\n";
+        for (int sq = 0; sq < 64; ++sq)
+            out << "    {0x" << std::hex << std::setw(16) << std::setfill('0') << data[sq].mask << ", 0x"
+                << std::setw(16) << data[sq].magic << std::dec << ", " << data[sq].offset << ", " << data[sq].shift
+                << (sq != 63 ? "},\n" : "}\n");
+        out << "};\n\n";
+    };
+
+    out << "// Generated by tools/magic_generator.cpp (fancy magics, packed table"
+        << (use_pext ? ", PEXT index order)\n" : ")\n");
+    out << "#include \"Magics.hpp\"\n\n";
+    // The index order must match the lookup in Attacks.hpp
+    if (use_pext)
+        out << "#ifndef USE_PEXT\n#error \"Magics.cpp was generated for PEXT indexing - build with -DENGINE_PEXT=ON\"\n#endif\n\n";
+    else
+        out << "#ifdef USE_PEXT\n#error \"Magics.cpp was generated for magic indexing - regenerate it with --pext\"\n#endif\n\n";
+    out << "namespace magics\n{\n\n";
+
+    print_magics("rook", rook_data);
+    print_magics("bishop", bishop_data);
+
+    out << "const Bitboard attacks[" << packed.size() << "] = {\n    ";
+    for (std::size_t i = 0; i < packed.size(); ++i)
+    {
+        out << "0x" << std::hex << std::setw(16) << std::setfill('0') << packed[i] << std::dec;
+        if (i + 1 != packed.size())
+            out << ((i + 1) % 4 == 0 ? ",\n    " : ",");
     }
-    std::cerr << "Rook table size: " << rook_total * sizeof(Bitboard) / 1024.0 << " KB\n";
-    std::cerr << "Bishop table size: " << bishop_total * sizeof(Bitboard) / 1024.0 << " KB\n";
+    out << "\n};\n\n";
+
+    out << "} // namespace magics\n";
+
+    std::cerr << "Attack table size: " << packed.size() * sizeof(Bitboard) / 1024.0 << " KB\n";
 }